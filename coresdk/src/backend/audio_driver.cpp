@@ -93,7 +93,7 @@ namespace splashkit_lib
     sk_sound_data sk_load_sound_data(string filename, sk_sound_kind kind)
     {
         internal_sk_init();
-        sk_sound_data result = { SGSD_UNKNOWN, NULL } ;
+        sk_sound_data result = { SGSD_UNKNOWN, NULL, NULL } ;
 
         result.kind = kind;
 
@@ -123,6 +123,50 @@ namespace splashkit_lib
         return result;
     }
 
+    sk_sound_data sk_load_sound_data_from_memory(const char *data, unsigned long size, sk_sound_kind kind)
+    {
+        internal_sk_init();
+        sk_sound_data result = { SGSD_UNKNOWN, NULL, NULL } ;
+
+        result.kind = kind;
+
+        switch (kind)
+        {
+            case SGSD_SOUND_EFFECT:
+            {
+                // sound effects are fully decoded, so the data is only needed while loading
+                result._data = Mix_LoadWAV_RW(SDL_RWFromConstMem(data, static_cast<int>(size)), 1);
+                break;
+            }
+            case SGSD_MUSIC:
+            {
+                // music is decoded as it plays, so keep a copy of the data for as long as the music exists
+                result._memory = malloc(size);
+                if ( ! result._memory ) return result;
+                memcpy(result._memory, data, size);
+
+                result._data = Mix_LoadMUS_RW(SDL_RWFromConstMem(result._memory, static_cast<int>(size)), 1);
+                if ( ! result._data )
+                {
+                    free(result._memory);
+                    result._memory = NULL;
+                }
+                break;
+            }
+
+            case SGSD_UNKNOWN:
+            default:
+                return result;
+        }
+
+        if(result._data == nullptr)
+        {
+            cerr << Mix_GetError() << endl;
+        }
+
+        return result;
+    }
+
     void sk_close_sound_data(sk_sound_data * sound )
     {
         if ( (!sound) || (!sound->_data) ) return;
@@ -131,6 +175,8 @@ namespace splashkit_lib
         {
             case SGSD_MUSIC:
                 Mix_FreeMusic(static_cast<Mix_Music *>(sound->_data));
+                free(sound->_memory); // music stops reading its data once freed
+                sound->_memory = NULL;
                 break;
 
             case SGSD_SOUND_EFFECT:
@@ -149,6 +195,13 @@ namespace splashkit_lib
         sound->_data = NULL;
     }
 
+    unsigned long sk_sound_data_size(sk_sound_data * sound)
+    {
+        if ( (!sound) || (!sound->_data) || sound->kind != SGSD_SOUND_EFFECT ) return 0;
+
+        return static_cast<Mix_Chunk *>(sound->_data)->alen;
+    }
+
     void sk_play_sound(sk_sound_data * sound, int loops, float volume)
     {
         if ( (!sound) || (!sound->_data) ) return;
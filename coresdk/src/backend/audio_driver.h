@@ -30,6 +30,9 @@ namespace splashkit_lib
 
         // private data used by backend
         void * _data;
+
+        // encoded data for music loaded from memory - SDL_mixer streams from it while playing
+        void * _memory;
     } sk_sound_data;
 
 
@@ -41,9 +44,13 @@ namespace splashkit_lib
     int sk_get_channel(sk_sound_data *sound);
 
     sk_sound_data sk_load_sound_data(string filename, sk_sound_kind kind);
+    sk_sound_data sk_load_sound_data_from_memory(const char *data, unsigned long size, sk_sound_kind kind);
 
     void sk_close_sound_data(sk_sound_data * sound );
 
+    // The size of the decoded samples of a sound effect. Music is streamed, so has no decoded size.
+    unsigned long sk_sound_data_size(sk_sound_data * sound);
+
     void sk_play_sound(sk_sound_data * sound, int loops, float volume);
 
     float sk_sound_playing(sk_sound_data * sound);
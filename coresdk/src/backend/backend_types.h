@@ -15,6 +15,7 @@
 #include "color.h"
 #include "networking.h"
 #include "web_server.h"
+#include "web_client.h"
 
 #include "concurrency_utils.h"
 #include "civetweb.h"
@@ -54,13 +55,16 @@ namespace splashkit_lib
         HTTP_REQUEST_PTR =          0x48524551, //'HREQ';
         HTTP_RESPONSE_PTR =         0x48524553, //'HRES';
         WEB_SERVER_PTR =            0x57535652, //'WSVR';
+        WEBSOCKET_PTR =             0x57534b54, //'WSKT';
         CONNECTION_PTR =            0x434f4e50, //'CONP';
         MESSAGE_PTR =               0x4d534750, //'MSGP';
         SERVER_SOCKET_PTR =         0x53565253, //'SVRS';
         NETWORK_CONNECTION_PTR =    0x4e545743, //'NTWC';
         DISPLAY_PTR =               0x44495350, //'DISP';
         QUERY_PTR =                 0x51555259, //'QURY';
+        PENDING_REQUEST_PTR =       0x50524551, //'PREQ';
         JSON_PTR =                  0x4a534f4e, //'JSON';
+        JSON_VIEW_PTR =             0x4a535657, //'JSVW';
         NONE_PTR =                  0x4e4f4e45  //'NONE';
     };
 
@@ -165,6 +169,12 @@ namespace splashkit_lib
 
         bool                was_downloaded;
 
+        // The encoded font file when loaded from memory, kept so other sizes can be opened
+        string              _memory;
+
+        // Size of the encoded font, used to estimate the memory of each open size
+        unsigned long       _file_size;
+
         // TTF_Font Private Data
         map<int, void *> _data;
     };
@@ -225,6 +235,9 @@ namespace splashkit_lib
         // UDP
         string host;
         int port;
+
+        // WebSocket
+        sk_websocket_data* websocket = nullptr;
     };
 
     struct sk_http_response
@@ -247,6 +260,10 @@ namespace splashkit_lib
         string              query_string;
         http_method         method;
 
+        // Decoded name/value pairs from the query string, in request order.
+        // Parsed once when the request arrives, so lookups do not re-decode.
+        vector<std::pair<string, string>> query_parameters;
+
         unsigned short      port;
         string              body;
         string              filename;
@@ -258,6 +275,51 @@ namespace splashkit_lib
         sk_web_server       *server;
     };
 
+    struct sk_pending_request
+    {
+        pointer_identifier      id;
+        http_method             method;
+        string                  uri;
+        unsigned short          port;
+        string                  body;
+        vector<string>          headers;
+        http_response_callback  *on_complete;
+
+        // curl state used by the request thread while the transfer is in flight
+        void                    *_transfer;
+
+        // Guards the fields below, which the request thread and the user both update
+        mutex                   lock;
+        condition_variable      finished;
+        bool                    complete;
+        bool                    released;           // Freed by the user - delete once the request thread is done
+        bool                    callback_pending;   // Waiting for on_complete to be called from process_events
+        sk_http_response        *response;
+    };
+
+    struct sk_websocket_endpoint
+    {
+        sk_web_server       *server;
+        string              path;
+    };
+
+    struct sk_websocket_data
+    {
+        pointer_identifier      id;
+        sk_websocket_endpoint   *endpoint;
+
+        // Guards conn - civetweb closes the connection from its own thread
+        mutex                   lock;
+        struct mg_connection    *conn;
+        bool                    open;
+
+        // Set when the user closes the socket, so the close handler passes it on to be deleted
+        bool                    released;
+
+        // Data from fragmented frames, waiting for the final frame
+        vector<int8_t>          part_msg_data;
+    };
+
     struct sk_web_server
     {
         pointer_identifier          id;
@@ -274,6 +336,26 @@ namespace splashkit_lib
          * These must be responded to before the server can be closed.
          */
         vector<sk_http_request*>    outstanding_requests;
+
+        // Guards websocket_endpoints and the websocket lists below, which civetweb threads update
+        mutex                           websocket_lock;
+        vector<sk_websocket_endpoint*>  websocket_endpoints;
+        vector<sk_websocket_data*>      websockets;
+
+        // Closed by the client, but not yet released by the user
+        vector<sk_websocket_data*>      closed_websockets;
+
+        // Released by the user and closed, waiting to be deleted on the user's thread
+        vector<sk_websocket_data*>      finished_websockets;
+
+        // Handed over from civetweb threads, then collected on the user's thread
+        channel<sk_websocket_data*>     new_websocket_queue;
+        channel<sk_message*>            websocket_message_queue;
+        vector<sk_websocket_data*>      new_websockets;
+        vector<sk_message*>             websocket_messages;
+
+        // Messages the user has read, which still refer to their websocket
+        vector<sk_message*>             read_websocket_messages;
     };
 
     struct animation_frame
@@ -12,14 +12,17 @@
 #include <mutex>
 #include <thread>
 #include <condition_variable>
-#include <queue>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 
 using std::mutex;
 using std::thread;
 using std::condition_variable;
 using std::unique_lock;
 using std::lock_guard;
-using std::queue;
+using std::atomic;
 
 namespace splashkit_lib
 {
@@ -66,55 +69,200 @@ namespace splashkit_lib
         {
             lock_guard<mutex> lock(_mutex);
             _tokens += num;
-            _cv.notify_all();
+
+            // Only wake as many waiters as there are new tokens
+            if (num == 1)
+                _cv.notify_one();
+            else
+                _cv.notify_all();
+        }
+    };
+
+    /**
+     * A bounded multi-producer, multi-consumer queue that does not lock.
+     *
+     * Each slot carries a sequence number that tells producers and consumers
+     * whether it is ready for them, so a push or pop is a single compare and
+     * swap on the shared position in the common case. CAPACITY must be a
+     * power of two.
+     */
+    template <typename T, size_t CAPACITY = 1024>
+    class mpmc_queue
+    {
+    private:
+        static_assert(CAPACITY >= 2 and (CAPACITY & (CAPACITY - 1)) == 0, "mpmc_queue capacity must be a power of two");
+
+        // Keep the producer and consumer positions on separate cache lines
+        static const size_t CACHE_LINE = 64;
+
+        struct cell
+        {
+            atomic<size_t>  sequence;
+            T               data;
+        };
+
+        cell _buffer[CAPACITY];
+        alignas(CACHE_LINE) atomic<size_t> _enqueue_pos;
+        alignas(CACHE_LINE) atomic<size_t> _dequeue_pos;
+
+    public:
+        mpmc_queue()
+        {
+            for (size_t i = 0; i < CAPACITY; i++)
+            {
+                _buffer[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            _enqueue_pos.store(0, std::memory_order_relaxed);
+            _dequeue_pos.store(0, std::memory_order_relaxed);
+        }
+
+        mpmc_queue(const mpmc_queue &) = delete;
+        mpmc_queue &operator=(const mpmc_queue &) = delete;
+
+        bool try_push(const T &data)
+        {
+            size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+            cell *c;
+
+            for (;;)
+            {
+                c = &_buffer[pos & (CAPACITY - 1)];
+                size_t seq = c->sequence.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+                if (diff == 0)
+                {
+                    if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                {
+                    return false; // full
+                }
+                else
+                {
+                    pos = _enqueue_pos.load(std::memory_order_relaxed);
+                }
+            }
+
+            c->data = data;
+            c->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool try_pop(T &data)
+        {
+            size_t pos = _dequeue_pos.load(std::memory_order_relaxed);
+            cell *c;
+
+            for (;;)
+            {
+                c = &_buffer[pos & (CAPACITY - 1)];
+                size_t seq = c->sequence.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+                if (diff == 0)
+                {
+                    if (_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                {
+                    return false; // empty
+                }
+                else
+                {
+                    pos = _dequeue_pos.load(std::memory_order_relaxed);
+                }
+            }
+
+            data = c->data;
+            c->sequence.store(pos + CAPACITY, std::memory_order_release);
+            return true;
         }
     };
 
-    template <typename T>
+    /**
+     * A channel passes values between threads. Values are exchanged through
+     * a lock free `mpmc_queue`. The mutex and condition variable are only
+     * touched when a consumer has to sleep because the channel is empty, or
+     * a producer has to wake one up.
+     *
+     * The channel is unbounded: when the queue is full, values go to an
+     * overflow list behind a mutex, so put never blocks. Once values have
+     * overflowed, later values follow them until the overflow is drained, so
+     * the values from each producer are taken in the order they were put.
+     */
+    template <typename T, size_t CAPACITY = 1024>
     class channel
     {
     private:
-        queue<T> _queue;
-        semaphore _take_permission;
+        mpmc_queue<T, CAPACITY> _queue;
+
+        // Values put while the queue was full, and how many there are
+        std::deque<T> _overflow;
+        atomic<size_t> _overflowed {0};
+        mutex _overflow_mutex;
+
+        // Consumers blocked in take - producers only signal when this is non-zero
+        atomic<int> _waiting {0};
         mutex _mutex;
+        condition_variable _not_empty;
 
-        T dequeue()
+        bool _try_take(T &data)
         {
-            T data = _queue.front();
-            _queue.pop();
-            return data;
+            if (_queue.try_pop(data)) return true;
+            if (_overflowed.load() == 0) return false;
+
+            lock_guard<mutex> lock(_overflow_mutex);
+            if (_overflow.empty()) return false;
+
+            data = _overflow.front();
+            _overflow.pop_front();
+            _overflowed--;
+            return true;
         }
 
     public:
         void put(T data)
         {
-            unique_lock<mutex> lock(_mutex);
-            _queue.push(data);
-            lock.unlock();
+            if (_overflowed.load() > 0 or not _queue.try_push(data))
+            {
+                lock_guard<mutex> lock(_overflow_mutex);
+                _overflow.push_back(data);
+                _overflowed++;
+            }
+
+            // Pairs with the fence in take: either this sees the waiting consumer,
+            // or the consumer sees the value that was just put
+            std::atomic_thread_fence(std::memory_order_seq_cst);
 
-            _take_permission.release();
+            if (_waiting.load() > 0)
+            {
+                // Lock so the notify cannot slip in between a consumer's check and its wait
+                lock_guard<mutex> lock(_mutex);
+                _not_empty.notify_one();
+            }
         }
 
         T take()
         {
-            _take_permission.acquire();
-            
-            lock_guard<mutex> lock(_mutex);
-            return dequeue();
+            T data;
+            if (_try_take(data)) return data;
+
+            unique_lock<mutex> lock(_mutex);
+            _waiting++;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            _not_empty.wait(lock, [&] { return _try_take(data); });
+            _waiting--;
+
+            return data;
         }
-        
+
         bool try_take(T& data)
         {
-            if (_take_permission.try_acquire())
-            {
-                lock_guard<mutex> lock(_mutex);
-                data = dequeue();
-                return true;
-            }
-            
-            return false;
+            return _try_take(data);
         }
-        
     };
 }
 #endif // sgsdl2_SGSDL2ConcurrencyUtils_h
@@ -9,16 +9,115 @@
 #include <sqlite3.h>
 #include "utility_functions.h"
 #include "database_driver.h"
+#include "concurrency_utils.h"
 #include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <list>
+#include <thread>
+#include <unordered_map>
 
 #ifdef __linux__
 #include <string.h>
 #endif
+
+using std::list;
+using std::unordered_map;
+using std::mutex;
+using std::lock_guard;
+using std::unique_lock;
+using std::condition_variable;
+
 namespace splashkit_lib
 {
+    // Compiled statements kept per database, so repeated sql skips the parser and planner
+    static const size_t MAX_CACHED_STATEMENTS = 32;
+
+    // Read only connections used to run async queries in parallel, alongside the one async writer
+    static const int ASYNC_READ_CONNECTIONS = 3;
+
+    // How long a connection waits for another to finish writing before giving up
+    static const int BUSY_TIMEOUT_MS = 5000;
+
+    struct _cached_statement
+    {
+        string sql;
+        sqlite3_stmt *statement;
+    };
+
+    // Totals for each distinct sql statement run on a database
+    struct _statement_stats
+    {
+        long    count = 0;
+        double  total_ms = 0;
+        double  max_ms = 0;
+        long    rows_returned = 0;
+        long    vm_steps = 0;
+        long    full_scan_steps = 0;
+        long    sorts = 0;
+        long    auto_indexes = 0;
+    };
+
+    struct _slow_query
+    {
+        string sql;
+        string expanded_sql;
+        double ms;
+    };
+
+    // Shared by all of a database's connections, including those running async queries
+    struct _query_profile
+    {
+        mutex lock;
+        unordered_map<string, _statement_stats> statements;
+
+        // Statements are only traced while one of these is on. Each connection
+        // checks them before running a statement, see _update_trace.
+        atomic<bool> gather_stats {false};
+        atomic<double> slow_query_ms {0};
+
+        // Slow queries wait in the list to be explained, as the trace callback
+        // cannot use the connection. They are logged once the statement finishes.
+        vector<_slow_query> slow_queries;
+    };
+
+    // Worker threads that run async queries, each with its own connection to the database
+    struct _async_executor
+    {
+        channel<sk_query_result *> writes;
+        channel<sk_query_result *> reads;
+        vector<std::thread> threads;
+    };
+
+    // The backend data for a database - its connection and the idle statements, most recently used first
+    struct _database_data
+    {
+        sqlite3 *connection;
+
+        list<_cached_statement> idle_statements;
+        unordered_map<string, list<_cached_statement>::iterator> statement_cache;
+
+        _async_executor *executor = nullptr;
+
+        // Rows returned by each running statement, added to the profile when it finishes
+        _query_profile *profile;
+        bool owns_profile;
+        unsigned trace_mask = 0;
+        unordered_map<sqlite3_stmt *, long> rows_returned;
+    };
+
+    struct sk_query_task
+    {
+        string sql;
+
+        mutex lock;
+        condition_variable finished;
+        bool complete = false;
+    };
+
     sqlite3 *sqlite3_from_void(void *ptr)
     {
-        return static_cast<sqlite3*>(ptr);
+        return static_cast<_database_data*>(ptr)->connection;
     }
 
     sqlite3_stmt *sqlite3_stmt_from_void(void *ptr)
@@ -26,12 +125,140 @@ namespace splashkit_lib
         return static_cast<sqlite3_stmt*>(ptr);
     }
 
-    bool sk_open_database(string db_file_path, sk_database *result)
+    static bool _is_explain(const char *sql)
+    {
+        const char *explain = "explain";
+        for (int i = 0; explain[i]; i++)
+        {
+            if (tolower(static_cast<unsigned char>(sql[i])) != explain[i]) return false;
+        }
+        return true;
+    }
+
+    /**
+     * Records rows and run times of the statements on a connection. Called
+     * by SQLite as each row is returned and when each statement finishes.
+     */
+    static int _trace_statement(unsigned type, void *context, void *p, void *x)
+    {
+        _database_data *db_data = static_cast<_database_data*>(context);
+        sqlite3_stmt *statement = static_cast<sqlite3_stmt*>(p);
+
+        if (type == SQLITE_TRACE_ROW)
+        {
+            // internal statements, such as the one reading the schema, have no sql and are not
+            // profiled - counting their rows would add them to a later statement at the same address
+            if (sqlite3_sql(statement)) db_data->rows_returned[statement]++;
+            return 0;
+        }
+
+        const char *sql = sqlite3_sql(statement);
+        if (not sql or _is_explain(sql)) return 0;
+
+        double ms = *static_cast<sqlite3_int64*>(x) / 1000000.0;
+
+        long rows = 0;
+        auto it = db_data->rows_returned.find(statement);
+        if (it != db_data->rows_returned.end())
+        {
+            rows = it->second;
+            db_data->rows_returned.erase(it);
+        }
+
+        _query_profile *profile = db_data->profile;
+        double slow_query_ms = profile->slow_query_ms;
+        bool slow = slow_query_ms > 0 and ms >= slow_query_ms;
+
+        if (not (db_data->trace_mask & SQLITE_TRACE_ROW) and not slow) return 0;
+
+        lock_guard<mutex> lock(profile->lock);
+
+        if (db_data->trace_mask & SQLITE_TRACE_ROW)
+        {
+            _statement_stats &stats = profile->statements[sql];
+            stats.count++;
+            stats.total_ms += ms;
+            if (ms > stats.max_ms) stats.max_ms = ms;
+            stats.rows_returned += rows;
+
+            // reset the counters, as cached statements are run many times
+            stats.vm_steps += sqlite3_stmt_status(statement, SQLITE_STMTSTATUS_VM_STEP, 1);
+            stats.full_scan_steps += sqlite3_stmt_status(statement, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1);
+            stats.sorts += sqlite3_stmt_status(statement, SQLITE_STMTSTATUS_SORT, 1);
+            stats.auto_indexes += sqlite3_stmt_status(statement, SQLITE_STMTSTATUS_AUTOINDEX, 1);
+        }
+
+        if (slow)
+        {
+            char *expanded = sqlite3_expanded_sql(statement);
+            profile->slow_queries.push_back({ sql, expanded ? expanded : sql, ms });
+            sqlite3_free(expanded);
+        }
+
+        return 0;
+    }
+
+    /**
+     * Logs the slow queries waiting in the profile, along with the query
+     * plan SQLite chose for them.
+     */
+    static void _log_slow_queries(_database_data *db_data)
+    {
+        if (db_data->trace_mask == 0) return;
+
+        vector<_slow_query> slow_queries;
+        {
+            lock_guard<mutex> lock(db_data->profile->lock);
+            if (db_data->profile->slow_queries.empty()) return;
+            slow_queries.swap(db_data->profile->slow_queries);
+        }
+
+        for (const _slow_query &query : slow_queries)
+        {
+            string plan;
+            sqlite3_stmt *explain;
+            string explain_sql = "EXPLAIN QUERY PLAN " + query.sql;
+
+            if (sqlite3_prepare_v2(db_data->connection, explain_sql.c_str(), -1, &explain, nullptr) == SQLITE_OK)
+            {
+                while (sqlite3_step(explain) == SQLITE_ROW)
+                {
+                    // the last column holds the detail, such as "SCAN t" or "SEARCH t USING INDEX ..."
+                    const unsigned char *detail = sqlite3_column_text(explain, sqlite3_column_count(explain) - 1);
+                    if (detail) plan += "\n    " + string(reinterpret_cast<const char *>(detail));
+                }
+            }
+            sqlite3_finalize(explain);
+
+            LOG(WARNING) << "Slow query took " << query.ms << "ms: " << query.expanded_sql << plan;
+        }
+    }
+
+    /**
+     * Traces the connection's statements while the profile gathers stats or
+     * logs slow queries. Rows are only counted while gathering stats.
+     */
+    static void _update_trace(_database_data *db_data)
+    {
+        unsigned mask = 0;
+        if (db_data->profile->gather_stats) mask = SQLITE_TRACE_PROFILE | SQLITE_TRACE_ROW;
+        else if (db_data->profile->slow_query_ms > 0) mask = SQLITE_TRACE_PROFILE;
+
+        if (mask == db_data->trace_mask) return;
+
+        sqlite3_trace_v2(db_data->connection, mask, mask ? _trace_statement : nullptr, db_data);
+        db_data->trace_mask = mask;
+
+        // counts for statements still running would be incomplete
+        db_data->rows_returned.clear();
+    }
+
+    static bool _open_connection(const string &db_file_path, int flags, _query_profile *profile, sk_database *result)
     {
         int rc;
         sqlite3 *data;
 
-        rc = sqlite3_open_v2(db_file_path.c_str(), &data, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+        rc = sqlite3_open_v2(db_file_path.c_str(), &data, flags, NULL);
 
         if (rc)
         {
@@ -42,27 +269,118 @@ namespace splashkit_lib
         }
         else
         {
-            result->_data = data;
+            _database_data *db_data = new _database_data;
+            db_data->connection = data;
+            db_data->owns_profile = profile == nullptr;
+            db_data->profile = profile ? profile : new _query_profile;
+            _update_trace(db_data);
+
+            result->_data = db_data;
             return true;
         }
     }
 
+    bool sk_open_database(string db_file_path, sk_database *result)
+    {
+        return _open_connection(db_file_path, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr, result);
+    }
+
+    static void _stop_async_executor(_database_data *db_data);
+
     int sk_close_database(sk_database *db)
     {
-        int rc = sqlite3_close_v2(sqlite3_from_void(db->_data));
+        _database_data *db_data = static_cast<_database_data*>(db->_data);
+
+        // let the workers finish the queries already queued, then close their connections
+        _stop_async_executor(db_data);
+        _log_slow_queries(db_data);
+
+        for (const _cached_statement &cached : db_data->idle_statements)
+        {
+            sqlite3_finalize(cached.statement);
+        }
+
+        // statements finishing after this point must not be traced into the freed data
+        sqlite3_trace_v2(db_data->connection, 0, nullptr, nullptr);
+
+        int rc = sqlite3_close_v2(db_data->connection);
         if (rc != SQLITE_OK)
         {
             LOG(WARNING) << "Could not close database";
         }
+
+        if (db_data->owns_profile) delete db_data->profile;
+        delete db_data;
+        db->_data = nullptr;
         return rc;
     }
 
+    /**
+     * Takes an idle statement for the sql from the cache, or returns nullptr
+     * if there is none. The statement is in use until it is returned with
+     * _return_cached_statement.
+     */
+    static sqlite3_stmt *_take_cached_statement(_database_data *db_data, const string &sql)
+    {
+        auto it = db_data->statement_cache.find(sql);
+        if (it == db_data->statement_cache.end()) return nullptr;
+
+        sqlite3_stmt *statement = it->second->statement;
+        db_data->idle_statements.erase(it->second);
+        db_data->statement_cache.erase(it);
+        return statement;
+    }
+
+    static void _return_cached_statement(_database_data *db_data, const string &sql, sqlite3_stmt *statement)
+    {
+        sqlite3_reset(statement);
+        sqlite3_clear_bindings(statement);
+
+        if (db_data->statement_cache.count(sql) > 0)
+        {
+            // another copy of this statement is already waiting to be reused
+            sqlite3_finalize(statement);
+            return;
+        }
+
+        db_data->idle_statements.push_front({ sql, statement });
+        db_data->statement_cache[sql] = db_data->idle_statements.begin();
+
+        if (db_data->idle_statements.size() > MAX_CACHED_STATEMENTS)
+        {
+            auto oldest = db_data->idle_statements.back();
+            db_data->statement_cache.erase(oldest.sql);
+            db_data->idle_statements.pop_back();
+            sqlite3_finalize(oldest.statement);
+        }
+    }
+
+    bool sk_exec_sql(sk_database *db, const string &sql)
+    {
+        char *error = nullptr;
+        int rc = sqlite3_exec(sqlite3_from_void(db->_data), sql.c_str(), nullptr, nullptr, &error);
+        if (rc != SQLITE_OK)
+        {
+            LOG(WARNING) << "Failed to run " << sql << ": " << (error ? error : sqlite3_errstr(rc));
+        }
+        sqlite3_free(error);
+        return rc == SQLITE_OK;
+    }
+
+    bool sk_in_transaction(sk_database *db)
+    {
+        return sqlite3_get_autocommit(sqlite3_from_void(db->_data)) == 0;
+    }
+
     int sk_step_statement(sk_query_result *result)
     {
         sqlite3_stmt *stmt = sqlite3_stmt_from_void(result->_stmt);
         result->_result = sqlite3_step(stmt);
         sqlite3 *data = sqlite3_from_void(result->_database->_data);
         result->_error_code = sqlite3_extended_errcode(data);
+
+        // the statement has finished, so report it now if it was slow
+        if (result->_result != SQLITE_ROW) _log_slow_queries(static_cast<_database_data*>(result->_database->_data));
         
         return result->_result;
     }
@@ -75,23 +393,75 @@ namespace splashkit_lib
 
     sk_query_result sk_prepare_statement(sk_database *db, string sql)
     {
-        const char* sql_char = sql.c_str();
-        int size_sql_inc_null = static_cast<int>(strlen(sql_char) + 1);
-
-        sqlite3 *data = sqlite3_from_void(db->_data);
-        sqlite3_stmt *statement;
+        _database_data *db_data = static_cast<_database_data*>(db->_data);
 
         sk_query_result result;
 
         result.id = QUERY_PTR;
         result._database = db;
-        result._result = sqlite3_prepare_v2(data, sql_char, size_sql_inc_null, &statement, nullptr);
+        result._sql = sql;
+
+        sqlite3_stmt *statement = _take_cached_statement(db_data, sql);
+        if (statement)
+        {
+            result._result = SQLITE_OK;
+            result._error_code = SQLITE_OK;
+            result._stmt = statement;
+            return result;
+        }
+
+        const char* sql_char = sql.c_str();
+        int size_sql_inc_null = static_cast<int>(strlen(sql_char) + 1);
+
+        result._result = sqlite3_prepare_v2(db_data->connection, sql_char, size_sql_inc_null, &statement, nullptr);
         result._error_code = result._result;
         result._stmt = statement;
         
         return result;
     }
 
+    /**
+     * Records the result of binding a parameter, so it is reported by
+     * sk_db_error_message when the bind fails.
+     */
+    static bool _bind_result(sk_query_result *result, int rc)
+    {
+        result->_error_code = rc;
+        if (rc != SQLITE_OK)
+        {
+            LOG(WARNING) << "Failed to bind query parameter: " << sqlite3_errstr(rc);
+            return false;
+        }
+        return true;
+    }
+
+    bool sk_bind_int(sk_query_result *result, int index, int value)
+    {
+        return _bind_result(result, sqlite3_bind_int(sqlite3_stmt_from_void(result->_stmt), index, value));
+    }
+
+    bool sk_bind_double(sk_query_result *result, int index, double value)
+    {
+        return _bind_result(result, sqlite3_bind_double(sqlite3_stmt_from_void(result->_stmt), index, value));
+    }
+
+    bool sk_bind_text(sk_query_result *result, int index, const string &value)
+    {
+        return _bind_result(result, sqlite3_bind_text(sqlite3_stmt_from_void(result->_stmt), index, value.c_str(), static_cast<int>(value.length()), SQLITE_TRANSIENT));
+    }
+
+    bool sk_bind_blob(sk_query_result *result, int index, const void *data, int size)
+    {
+        return _bind_result(result, sqlite3_bind_blob(sqlite3_stmt_from_void(result->_stmt), index, data, size, SQLITE_TRANSIENT));
+    }
+
+    void sk_reset_prepared_statement(sk_query_result *result)
+    {
+        sqlite3_reset(sqlite3_stmt_from_void(result->_stmt));
+        result->_result = SQLITE_OK;
+        result->_error_code = SQLITE_OK;
+    }
+
     bool sk_query_has_data(sk_query_result *result)
     {
         return result->_result == SQLITE_ROW;
@@ -175,13 +545,200 @@ namespace splashkit_lib
 
     void sk_finalise_query(sk_query_result *result)
     {
-        int rc = sqlite3_finalize(sqlite3_stmt_from_void(result->_stmt));
+        if (result->_task)
+        {
+            sk_wait_for_query(result);
+            delete result->_task;
+            result->_task = nullptr;
+            return;
+        }
+
+        sqlite3_stmt *statement = sqlite3_stmt_from_void(result->_stmt);
+
+        // keep the compiled statement for reuse - closing a database detaches its queries,
+        // so the database is still open if it is set
+        if (statement and result->_database and result->_database->_data)
+        {
+            _database_data *db_data = static_cast<_database_data*>(result->_database->_data);
+            _return_cached_statement(db_data, result->_sql, statement);
+
+            // resetting a statement that was not run to the end finishes it
+            _log_slow_queries(db_data);
+            return;
+        }
+
+        int rc = sqlite3_finalize(statement);
         if (rc != SQLITE_OK)
         {
             LOG(WARNING) << "Failed to finalise query statement";
         }
     }
 
+    void sk_detach_query(sk_query_result *result)
+    {
+        bool had_statement = result->_stmt != nullptr;
+
+        sk_finalise_query(result);
+        result->_stmt = nullptr;
+        result->_database = nullptr;
+
+        // rows already fetched can still be read, but the statement cannot be stepped again
+        if (had_statement)
+        {
+            result->_result = SQLITE_MISUSE;
+            result->_error_code = SQLITE_MISUSE;
+        }
+    }
+
+    double sk_query_column_number(const sk_query_column &column, int row)
+    {
+        switch (column.type)
+        {
+            case SK_INTEGER_COLUMN:
+                return static_cast<double>(column.integers[row]);
+            case SK_FLOAT_COLUMN:
+                return column.numbers[row];
+            default:
+                return atof(column.text[row].c_str());
+        }
+    }
+
+    string sk_query_column_text(const sk_query_column &column, int row)
+    {
+        if (column.type == SK_TEXT_COLUMN) return column.text[row];
+        if (column.nulls[row]) return "";
+
+        char text[32];
+        if (column.type == SK_INTEGER_COLUMN)
+            snprintf(text, sizeof(text), "%lld", static_cast<long long>(column.integers[row]));
+        else
+            snprintf(text, sizeof(text), "%.15g", column.numbers[row]);
+        return string(text);
+    }
+
+    /**
+     * Chooses how to store a fetched column from its value in the first row.
+     * Later rows may still hold other types, see _widen_column.
+     */
+    static sk_query_column_type _fetch_column_type(sqlite3_stmt *statement, int col)
+    {
+        switch (sqlite3_column_type(statement, col))
+        {
+            case SQLITE_INTEGER:
+                return SK_INTEGER_COLUMN;
+            case SQLITE_FLOAT:
+                return SK_FLOAT_COLUMN;
+            case SQLITE_NULL:
+                break;
+            default:
+                return SK_TEXT_COLUMN;
+        }
+
+        // null in the first row, so go by the column's declared type
+        const char *declared = sqlite3_column_decltype(statement, col);
+        if (not declared) return SK_TEXT_COLUMN;
+
+        string type = to_lower(declared);
+        if (type.find("int") != string::npos or type.find("bool") != string::npos)
+            return SK_INTEGER_COLUMN;
+        if (type.find("real") != string::npos or type.find("floa") != string::npos or
+            type.find("doub") != string::npos or type.find("num") != string::npos)
+            return SK_FLOAT_COLUMN;
+        return SK_TEXT_COLUMN;
+    }
+
+    /**
+     * Moves the values already fetched into the vector for a wider type, as
+     * SQLite lets any row hold a value of any type. Integers widen to float,
+     * and numbers widen to text.
+     */
+    static void _widen_column(sk_query_column &column, sk_query_column_type type)
+    {
+        int rows = static_cast<int>(column.nulls.size());
+
+        if (type == SK_TEXT_COLUMN)
+        {
+            column.text.reserve(column.nulls.capacity());
+            for (int row = 0; row < rows; row++)
+            {
+                column.text.push_back(sk_query_column_text(column, row));
+            }
+        }
+        else
+        {
+            column.numbers.reserve(column.nulls.capacity());
+            for (int64_t value : column.integers)
+            {
+                column.numbers.push_back(static_cast<double>(value));
+            }
+        }
+
+        column.integers.clear();
+        column.integers.shrink_to_fit();
+        if (type == SK_TEXT_COLUMN)
+        {
+            column.numbers.clear();
+            column.numbers.shrink_to_fit();
+        }
+        column.type = type;
+    }
+
+    int sk_query_fetch_rows(sk_query_result *result, int max_rows)
+    {
+        sqlite3_stmt *statement = sqlite3_stmt_from_void(result->_stmt);
+        int col_count = sk_column_count(result);
+
+        result->_columns.clear();
+        result->_columns.resize(col_count);
+        result->_fetched_rows = 0;
+
+        if (result->_result != SQLITE_ROW) return 0;
+
+        for (int col = 0; col < col_count; col++)
+        {
+            sk_query_column &column = result->_columns[col];
+            column.name = sqlite3_column_name(statement, col);
+            column.type = _fetch_column_type(statement, col);
+        }
+
+        while (result->_result == SQLITE_ROW and (max_rows < 0 or result->_fetched_rows < max_rows))
+        {
+            for (int col = 0; col < col_count; col++)
+            {
+                sk_query_column &column = result->_columns[col];
+                int value_type = sqlite3_column_type(statement, col);
+
+                // the first row's type may not suit later rows, so widen the column when needed
+                if (column.type != SK_TEXT_COLUMN and (value_type == SQLITE_TEXT or value_type == SQLITE_BLOB))
+                    _widen_column(column, SK_TEXT_COLUMN);
+                else if (column.type == SK_INTEGER_COLUMN and value_type == SQLITE_FLOAT)
+                    _widen_column(column, SK_FLOAT_COLUMN);
+
+                bool is_null = value_type == SQLITE_NULL;
+                column.nulls.push_back(is_null);
+
+                if (column.type == SK_TEXT_COLUMN)
+                {
+                    const unsigned char *text = sqlite3_column_text(statement, col);
+                    column.text.push_back(text ? string(reinterpret_cast<const char *>(text), sqlite3_column_bytes(statement, col)) : "");
+                }
+                else if (column.type == SK_INTEGER_COLUMN)
+                {
+                    column.integers.push_back(is_null ? 0 : sqlite3_column_int64(statement, col));
+                }
+                else
+                {
+                    column.numbers.push_back(is_null ? 0.0 : sqlite3_column_double(statement, col));
+                }
+            }
+
+            result->_fetched_rows++;
+            sk_step_statement(result);
+        }
+
+        return result->_fetched_rows;
+    }
+
     string sk_query_type_of_column(sk_query_result *result, int col)
     {
         if (result->_result == SQLITE_ROW)
@@ -209,4 +766,211 @@ namespace splashkit_lib
         LOG(WARNING) << "Failed to read type of column";
         return "";
     }    
+
+    /**
+     * Runs the queries from the queue on a connection of its own, reading all
+     * of each query's rows before marking it complete. A nullptr in the queue
+     * stops the worker.
+     */
+    static void _async_query_worker(string db_file_path, int flags, _query_profile *profile, channel<sk_query_result *> *queue)
+    {
+        sk_database worker;
+        worker.id = DATABASE_PTR;
+        worker.filename = db_file_path;
+
+        bool open = _open_connection(db_file_path, flags, profile, &worker);
+        if (open)
+            sqlite3_busy_timeout(sqlite3_from_void(worker._data), BUSY_TIMEOUT_MS);
+        else
+            LOG(WARNING) << "Failed to open connection to " << db_file_path << " to run async queries";
+
+        while (true)
+        {
+            sk_query_result *result = queue->take();
+            if (not result) break;
+
+            sk_query_task *task = result->_task;
+            sk_query_result query;
+
+            if (open)
+            {
+                // pick up changes to profiling made on the user's connection
+                _update_trace(static_cast<_database_data*>(worker._data));
+
+                query = sk_prepare_statement(&worker, task->sql);
+                if (sk_query_success(&query))
+                {
+                    sk_step_statement(&query);
+                    sk_query_fetch_rows(&query, -1);
+                }
+            }
+            else
+            {
+                query._result = SQLITE_CANTOPEN;
+                query._error_code = SQLITE_CANTOPEN;
+            }
+
+            {
+                lock_guard<mutex> lock(task->lock);
+                result->_result = query._result;
+                result->_error_code = query._error_code;
+                result->_columns = std::move(query._columns);
+                result->_fetched_rows = query._fetched_rows;
+                task->complete = true;
+
+                // notify while locked, as the waiting thread may delete the task as soon as it is released
+                task->finished.notify_all();
+            }
+
+            if (open) sk_finalise_query(&query);
+        }
+
+        if (open) sk_close_database(&worker);
+    }
+
+    static _async_executor *_start_async_executor(sk_database *db)
+    {
+        _database_data *db_data = static_cast<_database_data*>(db->_data);
+        if (db_data->executor) return db_data->executor;
+
+        // write ahead logging lets the readers run while the writer works
+        sk_exec_sql(db, "PRAGMA journal_mode=WAL;");
+        sqlite3_busy_timeout(db_data->connection, BUSY_TIMEOUT_MS);
+
+        _async_executor *executor = new _async_executor;
+        executor->threads.push_back(std::thread(_async_query_worker, db->filename, SQLITE_OPEN_READWRITE, db_data->profile, &executor->writes));
+        for (int i = 0; i < ASYNC_READ_CONNECTIONS; i++)
+        {
+            executor->threads.push_back(std::thread(_async_query_worker, db->filename, SQLITE_OPEN_READONLY, db_data->profile, &executor->reads));
+        }
+
+        db_data->executor = executor;
+        return executor;
+    }
+
+    static void _stop_async_executor(_database_data *db_data)
+    {
+        _async_executor *executor = db_data->executor;
+        if (not executor) return;
+
+        executor->writes.put(nullptr);
+        for (int i = 0; i < ASYNC_READ_CONNECTIONS; i++)
+        {
+            executor->reads.put(nullptr);
+        }
+
+        for (std::thread &worker : executor->threads)
+        {
+            worker.join();
+        }
+
+        delete executor;
+        db_data->executor = nullptr;
+    }
+
+    static void _complete_query_task(sk_query_result *result, int rc)
+    {
+        lock_guard<mutex> lock(result->_task->lock);
+        result->_result = rc;
+        result->_error_code = rc;
+        result->_task->complete = true;
+    }
+
+    void sk_run_query_async(sk_query_result *result, const string &sql)
+    {
+        sk_database *db = result->_database;
+
+        result->_stmt = nullptr;
+        result->_sql = sql;
+        result->_task = new sk_query_task;
+        result->_task->sql = sql;
+
+        // compile the sql here to catch errors early, and to find if it writes to the database
+        sk_query_result check = sk_prepare_statement(db, sql);
+        if (not sk_query_success(&check))
+        {
+            _complete_query_task(result, check._result);
+            sk_finalise_query(&check);
+            return;
+        }
+        bool read_only = sqlite3_stmt_readonly(sqlite3_stmt_from_void(check._stmt)) != 0;
+        sk_finalise_query(&check);
+
+        // other connections cannot see an in memory database, so run the query here
+        if (db->filename.empty() or db->filename == ":memory:" or db->filename.compare(0, 5, "file:") == 0)
+        {
+            sk_query_result query = sk_prepare_statement(db, sql);
+            sk_step_statement(&query);
+            sk_query_fetch_rows(&query, -1);
+
+            result->_columns = std::move(query._columns);
+            result->_fetched_rows = query._fetched_rows;
+            _complete_query_task(result, query._result);
+            result->_error_code = query._error_code;
+            sk_finalise_query(&query);
+            return;
+        }
+
+        _async_executor *executor = _start_async_executor(db);
+        if (read_only)
+            executor->reads.put(result);
+        else
+            executor->writes.put(result);
+    }
+
+    bool sk_query_complete(sk_query_result *result)
+    {
+        if (not result->_task) return true;
+
+        lock_guard<mutex> lock(result->_task->lock);
+        return result->_task->complete;
+    }
+
+    void sk_wait_for_query(sk_query_result *result)
+    {
+        if (not result->_task) return;
+
+        unique_lock<mutex> lock(result->_task->lock);
+        result->_task->finished.wait(lock, [result] { return result->_task->complete; });
+    }
+
+    vector<sk_statement_stats> sk_database_stats(sk_database *db)
+    {
+        _database_data *db_data = static_cast<_database_data*>(db->_data);
+
+        vector<sk_statement_stats> result;
+
+        lock_guard<mutex> lock(db_data->profile->lock);
+        for (const auto &entry : db_data->profile->statements)
+        {
+            const _statement_stats &stats = entry.second;
+            result.push_back({ entry.first, stats.count, stats.total_ms, stats.max_ms, stats.rows_returned, stats.vm_steps, stats.full_scan_steps, stats.sorts, stats.auto_indexes });
+        }
+
+        return result;
+    }
+
+    void sk_reset_database_stats(sk_database *db)
+    {
+        _database_data *db_data = static_cast<_database_data*>(db->_data);
+
+        lock_guard<mutex> lock(db_data->profile->lock);
+        db_data->profile->statements.clear();
+    }
+
+    void sk_set_slow_query_threshold(sk_database *db, double milliseconds)
+    {
+        _database_data *db_data = static_cast<_database_data*>(db->_data);
+
+        db_data->profile->slow_query_ms = milliseconds;
+        _update_trace(db_data);
+    }
+
+    void sk_set_database_profiling(sk_database *db, bool enabled)
+    {
+        _database_data *db_data = static_cast<_database_data*>(db->_data);
+
+        db_data->profile->gather_stats = enabled;
+        _update_trace(db_data);
+    }
 }
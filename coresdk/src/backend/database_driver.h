@@ -12,7 +12,10 @@
 #include "backend_types.h"
 
 #include <string>
+#include <vector>
+#include <cstdint>
 using std::string;
+using std::vector;
 
 namespace splashkit_lib
 {
@@ -25,14 +28,61 @@ namespace splashkit_lib
         void* _data;
     };
 
+    // How the values of a fetched column are stored
+    enum sk_query_column_type
+    {
+        SK_INTEGER_COLUMN,
+        SK_FLOAT_COLUMN,
+        SK_TEXT_COLUMN
+    };
+
+    // A column of the rows read by sk_query_fetch_rows. Values are stored in
+    // the vector for the column's type, with 0 or "" for rows that are null.
+    struct sk_query_column
+    {
+        string name;
+        sk_query_column_type type;
+        vector<int64_t> integers;
+        vector<double> numbers;
+        vector<string> text;
+        vector<bool> nulls;
+    };
+
+    // The totals for one sql statement, from the profile kept for each database
+    struct sk_statement_stats
+    {
+        string sql;
+        long count;
+        double total_ms;
+        double max_ms;
+        long rows_returned;
+        long vm_steps;
+        long full_scan_steps;
+        long sorts;
+        long auto_indexes;
+    };
+
+    // The state of a query being run by the async executor
+    struct sk_query_task;
+
     struct sk_query_result
     {
         pointer_identifier id;
 
         sk_database *_database;
         void *_stmt;
+        string _sql;
         int _result;
         int _error_code;
+
+        vector<sk_query_column> _columns;
+        int _fetched_rows = 0;
+
+        // Set for queries run by sk_run_query_async
+        sk_query_task *_task = nullptr;
+
+        // Index of this query in the list of open queries
+        size_t _slot = 0;
     };
 
     /**
@@ -42,14 +92,35 @@ namespace splashkit_lib
 
     int sk_close_database(sk_database *db);
 
+    /**
+     * Runs sql that returns no data, such as a pragma or transaction statement.
+     */
+    bool sk_exec_sql(sk_database *db, const string &sql);
+
+    bool sk_in_transaction(sk_database *db);
+
     int sk_step_statement(sk_query_result *result);
     
     string sk_db_error_message(sk_query_result *result);
 
     int sk_rows_affected(sk_database *db);
 
+    /**
+     * Compiled statements are reused from a cache, and returned to it by
+     * sk_finalise_query.
+     */
     sk_query_result sk_prepare_statement(sk_database *db, string sql);
 
+    bool sk_bind_int(sk_query_result *result, int index, int value);
+
+    bool sk_bind_double(sk_query_result *result, int index, double value);
+
+    bool sk_bind_text(sk_query_result *result, int index, const string &value);
+
+    bool sk_bind_blob(sk_query_result *result, int index, const void *data, int size);
+
+    void sk_reset_prepared_statement(sk_query_result *result);
+
     int sk_column_count(sk_query_result *result);
 
     bool sk_query_has_data(sk_query_result *result);
@@ -67,6 +138,62 @@ namespace splashkit_lib
     string sk_query_read_column_text(sk_query_result *result, int col);
 
     void sk_finalise_query(sk_query_result *result);
+
+    /**
+     * Finalises the query's statement and clears its database, so the query
+     * can be freed safely after its database has been closed.
+     */
+    void sk_detach_query(sk_query_result *result);
+
+    /**
+     * Reads a fetched value as a number. Text is converted, and null is 0.
+     */
+    double sk_query_column_number(const sk_query_column &column, int row);
+
+    /**
+     * Reads a fetched value as text - without a fraction for integer
+     * columns. Null is an empty string.
+     */
+    string sk_query_column_text(const sk_query_column &column, int row);
+
+    /**
+     * Reads up to max_rows rows, starting at the current row, into the
+     * result's columns. Use a negative max_rows to read all remaining rows.
+     * Returns the number of rows read.
+     */
+    int sk_query_fetch_rows(sk_query_result *result, int max_rows);
+
+    /**
+     * Runs the query on a background connection, reading all of its rows
+     * into the result's columns. Queries that write to the database are
+     * run one at a time, in order, on a single writer connection. Queries
+     * that only read are shared between a pool of read only connections.
+     * The database is switched to write ahead logging so readers and the
+     * writer can work at the same time.
+     */
+    void sk_run_query_async(sk_query_result *result, const string &sql);
+
+    bool sk_query_complete(sk_query_result *result);
+
+    void sk_wait_for_query(sk_query_result *result);
+
+    /**
+     * Every statement run on a database is profiled, recording how often it
+     * runs, how long it takes, the rows it returns, and the steps spent in
+     * full table scans, sorts and automatic indexes. Statements slower than
+     * the threshold are logged with their query plan.
+     */
+    vector<sk_statement_stats> sk_database_stats(sk_database *db);
+
+    void sk_reset_database_stats(sk_database *db);
+
+    void sk_set_slow_query_threshold(sk_database *db, double milliseconds);
+
+    /**
+     * Turns gathering the statistics for sk_database_stats on or off. They
+     * are off by default, as tracing every row slows down large queries.
+     */
+    void sk_set_database_profiling(sk_database *db, bool enabled);
     
     string sk_query_type_of_column(sk_query_result *result, int col);
     
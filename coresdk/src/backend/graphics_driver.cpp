@@ -21,6 +21,8 @@
 
 #include "png.h"
 #include <string.h>
+#include <vector>
+#include <algorithm>
 
 #include "core_driver.h"
 #include "graphics_driver.h"
@@ -33,6 +35,8 @@ namespace splashkit_lib
     unsigned int _sk_renderer_count(sk_drawing_surface *surface);
     SDL_Renderer * _sk_prepared_renderer(sk_drawing_surface* surface, unsigned int idx);
     void _sk_complete_render(sk_drawing_surface* surface, unsigned int idx);
+    void _sk_detach_from_atlas(sk_bitmap_be *bitmap);
+    void _sk_release_atlas_region(sk_bitmap_be *bitmap);
 
 
     static sk_window_be ** _sk_open_windows = nullptr;
@@ -110,6 +114,9 @@ namespace splashkit_lib
 
     void _sk_make_drawable(sk_bitmap_be *bitmap)
     {
+        // bitmaps in an atlas need their own textures before they can be drawn on
+        if ( bitmap->atlas ) _sk_detach_from_atlas(bitmap);
+
         // recreate all textures with target access
 
         int access, w, h;
@@ -630,6 +637,15 @@ namespace splashkit_lib
 
     void _sk_destroy_bitmap(sk_bitmap_be *bitmap_be)
     {
+        if ( bitmap_be->atlas )
+        {
+            // the atlas page owns the textures
+            _sk_release_atlas_region(bitmap_be);
+            SDL_FreeSurface(bitmap_be->surface);
+            free(bitmap_be);
+            return;
+        }
+
         _sk_remove_bitmap(bitmap_be);
 
         for (unsigned int bmp_idx = 0; bmp_idx < _sk_num_open_windows; bmp_idx++)
@@ -1850,6 +1866,8 @@ namespace splashkit_lib
         data->clip = {0, 0, width, height};
         data->drawable = true;
         data->surface = nullptr;
+        data->atlas = nullptr;
+        data->region = {0, 0, width, height};
         data->texture = static_cast<SDL_Texture **>(malloc(sizeof(SDL_Texture*) * _sk_num_open_windows));
         
         for (unsigned int i = 0; i < _sk_num_open_windows; i++)
@@ -1869,15 +1887,13 @@ namespace splashkit_lib
         return result;
     }
     
-    sk_drawing_surface sk_load_bitmap(const char * filename)
+    /**
+     * Wraps a decoded surface as a bitmap, creating a texture for each open window.
+     */
+    sk_drawing_surface _sk_bitmap_from_surface(SDL_Surface *surface)
     {
-        internal_sk_init();
         sk_drawing_surface result = { SGDS_Unknown, 0, 0, nullptr };
         
-        SDL_Surface *surface;
-        
-        surface = IMG_Load(filename);
-        
         if ( ! surface ) {
             std::cout << "error loading image " << IMG_GetError() << std::endl;
             return result;
@@ -1902,6 +1918,8 @@ namespace splashkit_lib
         data->drawable = false;
         data->clipped = false;
         data->clip = {0,0,0,0};
+        data->atlas = nullptr;
+        data->region = {0, 0, surface->w, surface->h};
         
         result.kind = SGDS_Bitmap;
         result.width = surface->w;
@@ -1912,6 +1930,326 @@ namespace splashkit_lib
         return result;
     }
     
+    sk_drawing_surface sk_load_bitmap(const char * filename)
+    {
+        internal_sk_init();
+        return _sk_bitmap_from_surface(IMG_Load(filename));
+    }
+    
+    sk_drawing_surface sk_load_bitmap_from_memory(const char * data, unsigned long size)
+    {
+        internal_sk_init();
+        
+        // IMG_Load_RW closes the read only view of the data once decoded
+        SDL_RWops *src = SDL_RWFromConstMem(data, static_cast<int>(size));
+        return _sk_bitmap_from_surface(IMG_Load_RW(src, 1));
+    }
+    
+    SDL_Surface *sk_decode_bitmap(const char * filename)
+    {
+        SDL_Surface *result = IMG_Load(filename);
+        if ( ! result )
+        {
+            std::cout << "error loading image " << IMG_GetError() << std::endl;
+        }
+        return result;
+    }
+    
+    SDL_Surface *sk_decode_bitmap_from_memory(const char * data, unsigned long size)
+    {
+        SDL_Surface *result = IMG_Load_RW(SDL_RWFromConstMem(data, static_cast<int>(size)), 1);
+        if ( ! result )
+        {
+            std::cout << "error loading image " << IMG_GetError() << std::endl;
+        }
+        return result;
+    }
+    
+    sk_drawing_surface sk_bitmap_from_decoded(SDL_Surface *surface)
+    {
+        internal_sk_init();
+        return _sk_bitmap_from_surface(surface);
+    }
+    
+    void sk_free_decoded_bitmap(SDL_Surface *surface)
+    {
+        if ( surface ) SDL_FreeSurface(surface);
+    }
+    
+    //--------------------------------------------------------------------------------------
+    //
+    // Atlas
+    //
+    //--------------------------------------------------------------------------------------
+
+    // Pages are square, and small enough for all renderers to support
+    static const int ATLAS_PAGE_SIZE = 2048;
+
+    // Larger bitmaps save little by sharing a texture, so keep their own
+    static const int ATLAS_MAX_BITMAP_SIZE = 512;
+
+    // Space left around each bitmap, so scaled drawing does not pick up its neighbours
+    static const int ATLAS_PADDING = 1;
+
+    // A horizontal segment of the top edge of the space used in a page
+    struct sk_skyline_node
+    {
+        int x, y, width;
+    };
+
+    struct sk_atlas_page
+    {
+        sk_drawing_surface          page;
+        std::vector<sk_skyline_node> skyline;
+        std::vector<sk_bitmap_be *> members;
+    };
+
+    static std::vector<sk_atlas_page *> _sk_atlas_pages;
+
+    //
+    // Returns the y position a rectangle of the given size would sit at on
+    // the skyline, starting at the node's x position, or -1 if it does not fit.
+    //
+    static int _sk_skyline_fit(const sk_atlas_page *page, size_t idx, int width, int height)
+    {
+        int x = page->skyline[idx].x;
+        if ( x + width > ATLAS_PAGE_SIZE ) return -1;
+
+        int y = page->skyline[idx].y;
+        int width_left = width;
+
+        for (size_t i = idx; width_left > 0; i++)
+        {
+            y = std::max(y, page->skyline[i].y);
+            if ( y + height > ATLAS_PAGE_SIZE ) return -1;
+            width_left -= page->skyline[i].width;
+        }
+
+        return y;
+    }
+
+    //
+    // Finds space for the rectangle using the bottom left skyline heuristic,
+    // and raises the skyline over the space used.
+    //
+    static bool _sk_skyline_insert(sk_atlas_page *page, int width, int height, SDL_Rect &result)
+    {
+        int best_y = INT_MAX, best_x = 0;
+        size_t best_idx = 0;
+
+        for (size_t i = 0; i < page->skyline.size(); i++)
+        {
+            int y = _sk_skyline_fit(page, i, width, height);
+            if ( y >= 0 and y + height < best_y )
+            {
+                best_y = y + height;
+                best_x = page->skyline[i].x;
+                best_idx = i;
+            }
+        }
+
+        if ( best_y == INT_MAX ) return false;
+
+        result = { best_x, best_y - height, width, height };
+
+        // The new node covers the rectangle, shortening or removing the nodes it overlaps
+        sk_skyline_node node = { best_x, best_y, width };
+        page->skyline.insert(page->skyline.begin() + static_cast<long>(best_idx), node);
+
+        for (size_t i = best_idx + 1; i < page->skyline.size(); )
+        {
+            sk_skyline_node &prev = page->skyline[i - 1];
+            sk_skyline_node &current = page->skyline[i];
+
+            int overlap = prev.x + prev.width - current.x;
+            if ( overlap <= 0 ) break;
+
+            current.x += overlap;
+            current.width -= overlap;
+
+            if ( current.width > 0 ) break;
+            page->skyline.erase(page->skyline.begin() + static_cast<long>(i));
+        }
+
+        // Join neighbouring nodes at the same height
+        for (size_t i = 0; i + 1 < page->skyline.size(); )
+        {
+            if ( page->skyline[i].y == page->skyline[i + 1].y )
+            {
+                page->skyline[i].width += page->skyline[i + 1].width;
+                page->skyline.erase(page->skyline.begin() + static_cast<long>(i + 1));
+            }
+            else i++;
+        }
+
+        return true;
+    }
+
+    //
+    // Copies part of the surface into the texture, converting the pixels if
+    // the renderer chose a different format for the texture.
+    //
+    static void _sk_update_texture_region(SDL_Texture *texture, SDL_Surface *surface, const SDL_Rect &rect)
+    {
+        Uint32 format;
+        SDL_QueryTexture(texture, &format, nullptr, nullptr, nullptr);
+
+        const Uint8 *src = static_cast<const Uint8 *>(surface->pixels) + rect.y * surface->pitch + rect.x * surface->format->BytesPerPixel;
+
+        if ( format == surface->format->format )
+        {
+            SDL_UpdateTexture(texture, &rect, src, surface->pitch);
+            return;
+        }
+
+        int pitch = rect.w * SDL_BYTESPERPIXEL(format);
+        void *pixels = malloc(static_cast<size_t>(pitch * rect.h));
+        if ( ! pixels ) return;
+
+        SDL_ConvertPixels(rect.w, rect.h, surface->format->format, src, surface->pitch, format, pixels, pitch);
+        SDL_UpdateTexture(texture, &rect, pixels, pitch);
+        free(pixels);
+    }
+
+    static sk_atlas_page *_sk_create_atlas_page()
+    {
+        SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, 32, SDL_PIXELFORMAT_RGBA8888);
+        if ( ! surface ) return nullptr;
+
+        // Start fully transparent
+        SDL_FillRect(surface, nullptr, 0);
+
+        sk_atlas_page *page = new sk_atlas_page();
+        page->page = _sk_bitmap_from_surface(surface);
+        page->skyline.push_back({ 0, 0, ATLAS_PAGE_SIZE });
+
+        _sk_atlas_pages.push_back(page);
+        return page;
+    }
+
+    //
+    // Copies the bitmap's pixels into the page, and updates the page's
+    // textures in each window.
+    //
+    static void _sk_copy_to_atlas_page(sk_atlas_page *page, sk_bitmap_be *bitmap, const SDL_Rect &rect)
+    {
+        sk_bitmap_be *page_be = static_cast<sk_bitmap_be *>(page->page._data);
+
+        // Copy alpha as is, rather than blending onto the empty page
+        SDL_BlendMode mode;
+        SDL_GetSurfaceBlendMode(bitmap->surface, &mode);
+        SDL_SetSurfaceBlendMode(bitmap->surface, SDL_BLENDMODE_NONE);
+
+        SDL_Rect dst = rect;
+        SDL_BlitSurface(bitmap->surface, nullptr, page_be->surface, &dst);
+
+        SDL_SetSurfaceBlendMode(bitmap->surface, mode);
+
+        for (unsigned int i = 0; i < _sk_num_open_windows; i++)
+        {
+            _sk_update_texture_region(page_be->texture[i], page_be->surface, rect);
+        }
+    }
+
+    bool sk_add_to_atlas(sk_drawing_surface *surface)
+    {
+        if ( ! surface || ! surface->_data || surface->kind != SGDS_Bitmap ) return false;
+
+        sk_bitmap_be *bitmap = static_cast<sk_bitmap_be *>(surface->_data);
+
+        if ( bitmap->atlas ) return true;
+        if ( bitmap->drawable || ! bitmap->surface ) return false;
+        if ( surface->width > ATLAS_MAX_BITMAP_SIZE || surface->height > ATLAS_MAX_BITMAP_SIZE ) return false;
+
+        int width = surface->width + 2 * ATLAS_PADDING;
+        int height = surface->height + 2 * ATLAS_PADDING;
+
+        SDL_Rect space;
+        sk_atlas_page *page = nullptr;
+
+        for (sk_atlas_page *current : _sk_atlas_pages)
+        {
+            if ( _sk_skyline_insert(current, width, height, space) )
+            {
+                page = current;
+                break;
+            }
+        }
+
+        if ( ! page )
+        {
+            page = _sk_create_atlas_page();
+            if ( ! page || ! _sk_skyline_insert(page, width, height, space) ) return false;
+        }
+
+        bitmap->region = { space.x + ATLAS_PADDING, space.y + ATLAS_PADDING, surface->width, surface->height };
+        _sk_copy_to_atlas_page(page, bitmap, bitmap->region);
+
+        // Drop the bitmap's own textures, as it is now drawn from the page
+        _sk_remove_bitmap(bitmap);
+        for (unsigned int i = 0; i < _sk_num_open_windows; i++)
+        {
+            SDL_DestroyTexture(bitmap->texture[i]);
+        }
+        free(bitmap->texture);
+        bitmap->texture = nullptr;
+
+        bitmap->atlas = page;
+        page->members.push_back(bitmap);
+
+        return true;
+    }
+
+    bool sk_in_atlas(sk_drawing_surface *surface)
+    {
+        if ( ! surface || ! surface->_data || surface->kind != SGDS_Bitmap ) return false;
+
+        return static_cast<sk_bitmap_be *>(surface->_data)->atlas != nullptr;
+    }
+
+    bool sk_bitmap_drawn_on(sk_drawing_surface *surface)
+    {
+        if ( ! surface || ! surface->_data || surface->kind != SGDS_Bitmap ) return false;
+
+        return static_cast<sk_bitmap_be *>(surface->_data)->drawable;
+    }
+
+    //
+    // Removes the bitmap from its page, closing the page once it is empty.
+    // The space it used is not reused until then.
+    //
+    void _sk_release_atlas_region(sk_bitmap_be *bitmap)
+    {
+        sk_atlas_page *page = bitmap->atlas;
+        bitmap->atlas = nullptr;
+
+        page->members.erase(std::remove(page->members.begin(), page->members.end(), bitmap), page->members.end());
+        if ( page->members.size() > 0 ) return;
+
+        _sk_atlas_pages.erase(std::remove(_sk_atlas_pages.begin(), _sk_atlas_pages.end(), page), _sk_atlas_pages.end());
+        _sk_destroy_bitmap(static_cast<sk_bitmap_be *>(page->page._data));
+        delete page;
+    }
+
+    //
+    // Gives the bitmap its own textures again, so that it can be drawn on.
+    //
+    void _sk_detach_from_atlas(sk_bitmap_be *bitmap)
+    {
+        if (_sk_num_open_windows > 0)
+            bitmap->texture = static_cast<SDL_Texture **>(malloc(sizeof(SDL_Texture*) * _sk_num_open_windows));
+
+        for (unsigned int i = 0; i < _sk_num_open_windows; i++)
+        {
+            bitmap->texture[i] = SDL_CreateTextureFromSurface(_sk_open_windows[i]->renderer, bitmap->surface);
+        }
+
+        _sk_release_atlas_region(bitmap);
+        bitmap->region = { 0, 0, bitmap->region.w, bitmap->region.h };
+
+        _sk_add_bitmap(bitmap);
+    }
+
     //x, y is the position to draw the bitmap to. As bitmaps scale around their centre, (x, y) is the top-left of the bitmap IF and ONLY IF scale = 1.
     //Angle is in degrees, 0 being right way up
     //Centre is the point to rotate around, relative to the bitmap centre (therefore (0,0) would rotate around the centre point)
@@ -1959,12 +2297,51 @@ namespace splashkit_lib
             static_cast<int>(src_h)
         };
         
-        // check if any size is 0... and return if nothing is to be drawn
-        if ( 0 == dst_rect.w || 0 == dst_rect.h || 0 == src_rect.w || 0 == src_rect.h ) return;
-        
         // Adjust centre to be relative to the bitmap centre rather than top-left
         centre_x = (centre_x * scale_x) + dst_rect.w / 2.0f;
         centre_y = (centre_y * scale_y) + dst_rect.h / 2.0f;
+
+        // Bitmaps in an atlas are drawn from their region of the page, without reading past its edges
+        sk_bitmap_be *src_be = static_cast<sk_bitmap_be *>(src->_data);
+        if ( src_be->atlas )
+        {
+            SDL_Rect bounds = { 0, 0, src_be->region.w, src_be->region.h };
+            SDL_Rect clipped;
+            if ( ! SDL_IntersectRect(&src_rect, &bounds, &clipped) ) return;
+
+            // Trim the destination by the same share of the source that was clipped,
+            // taking the trimmed edge from the other side when the bitmap is flipped
+            double dst_scale_x = dst_rect.w / static_cast<double>(src_rect.w);
+            double dst_scale_y = dst_rect.h / static_cast<double>(src_rect.h);
+
+            int left = clipped.x - src_rect.x;
+            int right = (src_rect.x + src_rect.w) - (clipped.x + clipped.w);
+            int top = clipped.y - src_rect.y;
+            int bottom = (src_rect.y + src_rect.h) - (clipped.y + clipped.h);
+
+            if ( flip == sk_FLIP_HORIZONTAL || flip == sk_FLIP_BOTH ) left = right;
+            if ( flip == sk_FLIP_VERTICAL || flip == sk_FLIP_BOTH ) top = bottom;
+
+            int clip_dx = static_cast<int>(left * dst_scale_x);
+            int clip_dy = static_cast<int>(top * dst_scale_y);
+
+            dst_rect.x += clip_dx;
+            dst_rect.y += clip_dy;
+            dst_rect.w = static_cast<int>(clipped.w * dst_scale_x);
+            dst_rect.h = static_cast<int>(clipped.h * dst_scale_y);
+
+            // Keep rotating around the same point of the screen
+            centre_x -= clip_dx;
+            centre_y -= clip_dy;
+
+            src_rect = clipped;
+            src_rect.x += src_be->region.x;
+            src_rect.y += src_be->region.y;
+            src_be = static_cast<sk_bitmap_be *>(src_be->atlas->page._data);
+        }
+
+        // check if any size is 0... and return if nothing is to be drawn
+        if ( 0 == dst_rect.w || 0 == dst_rect.h || 0 == src_rect.w || 0 == src_rect.h ) return;
         
         unsigned int count = _sk_renderer_count(dst);
         
@@ -1977,10 +2354,10 @@ namespace splashkit_lib
             {
                 unsigned int idx = static_cast<sk_window_be *>(dst->_data)->idx;
                 
-                srcT = static_cast<sk_bitmap_be *>(src->_data)->texture[ idx ];
+                srcT = src_be->texture[ idx ];
             }
             else
-                srcT = static_cast<sk_bitmap_be *>(src->_data)->texture[ i ];
+                srcT = src_be->texture[ i ];
             
             //Convert parameters to format SDL_RenderCopyEx expects
             SDL_Point centre = {
@@ -1998,6 +2375,12 @@ namespace splashkit_lib
     
     void sk_finalise_graphics()
     {
+        // Close the bitmaps in atlases, which closes their pages
+        while ( _sk_atlas_pages.size() > 0 )
+        {
+            _sk_destroy_bitmap(_sk_atlas_pages.back()->members.back());
+        }
+
         // Close all bitmaps
         for (unsigned int i = _sk_num_open_bitmaps; i > 0; i--)
         {
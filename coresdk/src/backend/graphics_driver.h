@@ -34,6 +34,8 @@ namespace splashkit_lib
         sk_drawing_surface *surface;
     };
 
+    struct sk_atlas_page;
+
     struct sk_bitmap_be
     {
         // 1 texture per open window
@@ -43,6 +45,11 @@ namespace splashkit_lib
         SDL_Rect        clip;
 
         bool            drawable; // can be drawn on
+
+        // Bitmaps in an atlas have no textures of their own, and are drawn
+        // from the region of the atlas page's textures
+        sk_atlas_page * atlas;
+        SDL_Rect        region;
     };
 
     sk_drawing_surface sk_open_window(const char *title, int width, int height);
@@ -51,6 +58,36 @@ namespace splashkit_lib
 
     sk_drawing_surface sk_load_bitmap(const char * filename);
 
+    sk_drawing_surface sk_load_bitmap_from_memory(const char * data, unsigned long size);
+
+    /**
+     * Decodes the image file without creating any textures, so it can be
+     * called from a background thread. Pass the result to
+     * sk_bitmap_from_decoded on the main thread to create the bitmap, or
+     * sk_free_decoded_bitmap if it is not needed. Returns nullptr if the
+     * image cannot be decoded.
+     */
+    SDL_Surface *sk_decode_bitmap(const char * filename);
+
+    SDL_Surface *sk_decode_bitmap_from_memory(const char * data, unsigned long size);
+
+    sk_drawing_surface sk_bitmap_from_decoded(SDL_Surface *surface);
+
+    void sk_free_decoded_bitmap(SDL_Surface *surface);
+
+    /**
+     * Moves a loaded bitmap into a shared atlas page, so that it is drawn from
+     * part of a larger texture along with other small bitmaps. Returns false
+     * if the bitmap cannot be moved, as it is too large or has been drawn on.
+     * The bitmap leaves the atlas when it is next drawn on.
+     */
+    bool sk_add_to_atlas(sk_drawing_surface *surface);
+
+    bool sk_in_atlas(sk_drawing_surface *surface);
+
+    // Has the bitmap been drawn on, so that it no longer matches the file it was loaded from
+    bool sk_bitmap_drawn_on(sk_drawing_surface *surface);
+
 
     void sk_draw_bitmap( sk_drawing_surface * src, sk_drawing_surface * dst, double * src_data, int src_data_sz, double * dst_data, int dst_data_sz, sk_renderer_flip flip );
 
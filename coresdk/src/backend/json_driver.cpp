@@ -14,11 +14,39 @@ namespace splashkit_lib
     {
         if (VALID_PTR(j, JSON_PTR))
         {
-            j->id = NONE_PTR;
-            delete j;
+            sk_json_clear_views(j);
+            delete_resource(j);
         }
     }
 
+    json_view sk_json_view_of(json owner, const backend_json *node)
+    {
+        sk_json_view *&view = owner->views[node];
+        if (view == nullptr)
+        {
+            view = new_resource<sk_json_view>();
+            view->id = JSON_VIEW_PTR;
+            view->owner = owner;
+            view->node = node;
+        }
+        return view;
+    }
+
+    void sk_json_clear_views(json j)
+    {
+        for (auto &entry : j->views)
+        {
+            delete_resource(entry.second);
+        }
+        j->views.clear();
+    }
+
+    void sk_free_json_view(json_view view)
+    {
+        view->owner->views.erase(view->node);
+        delete_resource(view);
+    }
+
     string json_type_to_string(backend_json::value_t type)
     {
         switch(type)
@@ -35,4 +63,278 @@ namespace splashkit_lib
             default: return "unknown";
         }
     }
-}
\ No newline at end of file
+
+    static vector<string> _split_json_pointer(const string &pointer)
+    {
+        vector<string> result;
+
+        size_t start = pointer.find('/');
+        while (start != string::npos)
+        {
+            size_t end = pointer.find('/', start + 1);
+            result.push_back(pointer.substr(start + 1, end == string::npos ? string::npos : end - start - 1));
+            start = end;
+        }
+
+        return result;
+    }
+
+    // Escapes a key as a JSON pointer segment, as ~ and / have special meanings
+    static string _json_pointer_segment(const string &key)
+    {
+        if (key.find_first_of("~/") == string::npos) return key;
+
+        string result;
+        for (char c : key)
+        {
+            if (c == '~') result += "~0";
+            else if (c == '/') result += "~1";
+            else result += c;
+        }
+        return result;
+    }
+
+    // Reverses the escaping of a JSON pointer segment
+    static string _json_pointer_key(const string &segment)
+    {
+        if (segment.find('~') == string::npos) return segment;
+
+        string result;
+        for (size_t i = 0; i < segment.length(); i++)
+        {
+            if (segment[i] == '~' and i + 1 < segment.length())
+            {
+                result += segment[i + 1] == '1' ? '/' : '~';
+                i++;
+            }
+            else result += segment[i];
+        }
+        return result;
+    }
+
+    const backend_json *sk_json_at_pointer(const backend_json &data, const string &pointer)
+    {
+        const backend_json *node = &data;
+
+        for (const string &segment : _split_json_pointer(pointer))
+        {
+            if (node->is_object())
+            {
+                auto it = node->find(_json_pointer_key(segment));
+                if (it == node->end()) return nullptr;
+                node = &*it;
+            }
+            else if (node->is_array())
+            {
+                if (segment.empty() or segment.length() > 18 or segment.find_first_not_of("0123456789") != string::npos) return nullptr;
+
+                size_t index = std::stoul(segment);
+                if (index >= node->size()) return nullptr;
+                node = &(*node)[index];
+            }
+            else return nullptr;
+        }
+
+        return node;
+    }
+
+    /**
+     * SAX handler that tracks the path to the current value, building only
+     * the values at paths that match the patterns.
+     */
+    class _json_stream_handler
+    {
+    public:
+        _json_stream_handler(const vector<std::string> &patterns, std::function<bool(const std::string &, backend_json &)> on_value)
+            : _on_value(on_value)
+        {
+            for (const std::string &pattern : patterns)
+            {
+                _patterns.push_back(_split_json_pointer(pattern));
+            }
+        }
+
+        bool null() { return _scalar(backend_json()); }
+        bool boolean(bool val) { return _scalar(val); }
+        bool number_integer(backend_json::number_integer_t val) { return _scalar(val); }
+        bool number_unsigned(backend_json::number_unsigned_t val) { return _scalar(val); }
+        bool number_float(backend_json::number_float_t val, const backend_json::string_t &) { return _scalar(val); }
+        bool string(backend_json::string_t &val) { return _scalar(val); }
+
+        template <typename binary_type>
+        bool binary(binary_type &val) { return _scalar(backend_json(val)); }
+
+        bool start_object(std::size_t) { return _start(false); }
+        bool end_object() { return _end(); }
+        bool start_array(std::size_t) { return _start(true); }
+        bool end_array() { return _end(); }
+
+        bool key(backend_json::string_t &val)
+        {
+            _levels.back().key = val;
+            return true;
+        }
+
+        bool parse_error(std::size_t position, const std::string &last_token, const nlohmann::detail::exception &ex)
+        {
+            LOG(WARNING) << "Invalid json at " << position << ": " << ex.what();
+            _failed = true;
+            return false;
+        }
+
+        bool failed() const { return _failed; }
+
+    private:
+        // An object or array that is open at the current point in the stream
+        struct _level
+        {
+            bool array;
+            size_t index;
+            std::string key;
+        };
+
+        vector<vector<std::string>> _patterns;
+        std::function<bool(const std::string &, backend_json &)> _on_value;
+        vector<_level> _levels;
+        bool _failed = false;
+
+        // The value being built, and the open containers within it
+        bool _capturing = false;
+        std::string _capture_path;
+        backend_json _capture;
+        vector<backend_json *> _build;
+
+        vector<std::string> _path_segments() const
+        {
+            vector<std::string> result;
+            for (const _level &level : _levels)
+            {
+                result.push_back(level.array ? std::to_string(level.index) : _json_pointer_segment(level.key));
+            }
+            return result;
+        }
+
+        bool _matches(const vector<std::string> &segments) const
+        {
+            // with no patterns every scalar is reported
+            if (_patterns.empty()) return false;
+
+            for (const vector<std::string> &pattern : _patterns)
+            {
+                if (pattern.size() != segments.size()) continue;
+
+                bool match = true;
+                for (size_t i = 0; match and i < pattern.size(); i++)
+                {
+                    match = pattern[i] == "*" or pattern[i] == segments[i];
+                }
+                if (match) return true;
+            }
+            return false;
+        }
+
+        static std::string _join(const vector<std::string> &segments)
+        {
+            std::string result;
+            for (const std::string &segment : segments)
+            {
+                result += "/" + segment;
+            }
+            return result;
+        }
+
+        // Adds a value to the innermost container being built, returning where it was put
+        backend_json *_add_to_capture(backend_json &&val)
+        {
+            backend_json *parent = _build.back();
+            if (parent->is_array())
+            {
+                parent->push_back(std::move(val));
+                return &parent->back();
+            }
+
+            backend_json &child = (*parent)[_levels.back().key];
+            child = std::move(val);
+            return &child;
+        }
+
+        // Moves on to the next index once a value in an array has been read
+        void _value_done()
+        {
+            if (_levels.size() > 0 and _levels.back().array) _levels.back().index++;
+        }
+
+        bool _scalar(backend_json &&val)
+        {
+            bool keep_going = true;
+
+            if (_capturing)
+            {
+                _add_to_capture(std::move(val));
+            }
+            else
+            {
+                vector<std::string> segments = _path_segments();
+                if (_patterns.empty() or _matches(segments))
+                {
+                    keep_going = _on_value(_join(segments), val);
+                }
+            }
+
+            _value_done();
+            return keep_going;
+        }
+
+        bool _start(bool array)
+        {
+            backend_json container = array ? backend_json::array() : backend_json::object();
+
+            if (_capturing)
+            {
+                _build.push_back(_add_to_capture(std::move(container)));
+            }
+            else
+            {
+                vector<std::string> segments = _path_segments();
+                if (_matches(segments))
+                {
+                    _capturing = true;
+                    _capture_path = _join(segments);
+                    _capture = std::move(container);
+                    _build.push_back(&_capture);
+                }
+            }
+
+            _levels.push_back({ array, 0, "" });
+            return true;
+        }
+
+        bool _end()
+        {
+            bool keep_going = true;
+
+            _levels.pop_back();
+
+            if (_capturing)
+            {
+                _build.pop_back();
+                if (_build.empty())
+                {
+                    _capturing = false;
+                    keep_going = _on_value(_capture_path, _capture);
+                    _capture = backend_json();
+                }
+            }
+
+            _value_done();
+            return keep_going;
+        }
+    };
+
+    bool sk_json_parse_stream(std::istream &input, const vector<string> &patterns, std::function<bool(const string &, backend_json &)> on_value)
+    {
+        _json_stream_handler handler(patterns, on_value);
+        backend_json::sax_parse(input, &handler);
+        return not handler.failed();
+    }
+}
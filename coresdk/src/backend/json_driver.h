@@ -17,6 +17,8 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include <istream>
+#include <unordered_map>
 
 using backend_json = nlohmann::json;
 using std::string;
@@ -25,14 +27,62 @@ using std::make_pair;
 
 namespace splashkit_lib
 {
+    struct sk_json_view
+    {
+        pointer_identifier id;
+        json owner;
+        const backend_json *node;
+    };
+
     struct sk_json
     {
         pointer_identifier id;
         backend_json data;
+        // Views into data, one per node, freed with this object
+        std::unordered_map<const backend_json *, sk_json_view *> views;
+
+        // Index of this object in the list of json objects, and in its arena
+        size_t slot = 0;
+        int arena = -1;
+        size_t arena_slot = 0;
     };
 
     void sk_delete_json(json j);
 
+    /**
+     * Returns the view of the node within the owner's data, reusing the
+     * view if one was already made for that node.
+     */
+    json_view sk_json_view_of(json owner, const backend_json *node);
+
+    /**
+     * Frees the views into the json, as changes to its data may move or
+     * remove the nodes they refer to. Views come from a resource pool, so
+     * a view the user still holds fails VALID_PTR once freed.
+     */
+    void sk_json_clear_views(json j);
+
+    /**
+     * Frees a single view, removing it from its owner.
+     */
+    void sk_free_json_view(json_view view);
+
+    /**
+     * Finds the node at the JSON pointer path (e.g. "/players/3/score")
+     * within the data. Returns nullptr if there is no node at that path.
+     */
+    const backend_json *sk_json_at_pointer(const backend_json &data, const string &pointer);
+
+    /**
+     * Parses the json from the stream without building the whole document.
+     * Each value at a path matching one of the patterns is built and passed
+     * to on_value, then discarded. Patterns are JSON pointers, where a `*`
+     * segment matches any key or array index. With no patterns every
+     * scalar value is passed to on_value. Parsing stops if on_value returns
+     * false. Returns false if the json is invalid.
+     */
+    bool sk_json_parse_stream(std::istream &input, const vector<string> &patterns, std::function<bool(const string &, backend_json &)> on_value);
+
     string json_type_to_string(backend_json::value_t type);
 
     template <typename T>
@@ -44,6 +94,7 @@ namespace splashkit_lib
             return;
         }
 
+        sk_json_clear_views(j);
         j->data[key] = value;
     }
 
@@ -54,25 +105,39 @@ namespace splashkit_lib
                 type == backend_json::value_t::number_unsigned);
     }
 
+    inline const backend_json *sk_json_find(const backend_json &data, const string &key)
+    {
+        if (not data.is_object()) return nullptr;
+
+        auto it = data.find(key);
+        return it == data.end() ? nullptr : &*it;
+    }
+
     template<typename T>
-    T sk_json_read_value(json j, string key, backend_json::value_t type)
+    T sk_json_read_node(const backend_json *node, backend_json::value_t type)
     {
-        if (INVALID_PTR(j, JSON_PTR))
+        backend_json::value_t node_type = node ? node->type() : backend_json::value_t::null;
+
+        if ((node_type != type) &&
+            !(is_type_number(node_type) && is_type_number(type)))
         {
-            LOG(ERROR) << "Invalid json pointer passed to json_read_x";
+            LOG(ERROR) << "JSON key value is not expected in sk_json_read_value. Has type " << json_type_to_string(node_type);
             return T();
         }
 
-        backend_json temp = j->data[key];
+        return node->get<T>();
+    }
 
-        if ((temp.type() != type) &&
-            !(is_type_number(temp.type()) && is_type_number(type)))
+    template<typename T>
+    T sk_json_read_value(json j, string key, backend_json::value_t type)
+    {
+        if (INVALID_PTR(j, JSON_PTR))
         {
-            LOG(ERROR) << "JSON key value is not expected in sk_json_read_value. Has type " << json_type_to_string(j->data[key].type());
+            LOG(ERROR) << "Invalid json pointer passed to json_read_x";
             return T();
         }
 
-        return j->data[key];
+        return sk_json_read_node<T>(sk_json_find(j->data, key), type);
     }
 
     template <typename T>
@@ -84,18 +149,18 @@ namespace splashkit_lib
             return;
         }
 
-        if (!j->data[key].is_array())
+        const backend_json *json_array = sk_json_find(j->data, key);
+        if (json_array == nullptr or !json_array->is_array())
         {
-            LOG(ERROR) << "JSON key value is not an array. Has type " << json_type_to_string(j->data[key].type());
+            LOG(ERROR) << "JSON key value is not an array. Has type " << json_type_to_string(json_array ? json_array->type() : backend_json::value_t::null);
             return;
         }
-        
+
         out.clear();
-        
-        backend_json json_array = j->data[key];
-        
-        for (T e : json_array) {
-            out.push_back(e);
+        out.reserve(json_array->size());
+
+        for (const backend_json &e : *json_array) {
+            out.push_back(e.get<T>());
         }
     }
 
@@ -0,0 +1,376 @@
+//
+//  pack_driver.cpp
+//  splashkit
+//
+
+#include "pack_driver.h"
+#include "utility_functions.h"
+
+#include <fstream>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+#include <zlib.h>
+
+#ifdef WINDOWS
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using std::ifstream;
+using std::ofstream;
+
+namespace splashkit_lib
+{
+    static const char PACK_MAGIC[8] = { 'S', 'K', 'P', 'A', 'K', '\r', '\n', 0x1a };
+    static const uint32_t PACK_VERSION = 1;
+    static const size_t PACK_HEADER_SIZE = 32;
+
+    // Entry data starts on this boundary, so decoders can read it in place
+    static const size_t PACK_ALIGNMENT = 16;
+
+    // Deflate cannot expand data by more than this, so larger sizes mean a corrupt index
+    static const uint64_t PACK_MAX_ZLIB_RATIO = 1032;
+
+    static uint32_t _read_u32(const char *p)
+    {
+        const unsigned char *b = reinterpret_cast<const unsigned char *>(p);
+        return uint32_t(b[0]) | uint32_t(b[1]) << 8 | uint32_t(b[2]) << 16 | uint32_t(b[3]) << 24;
+    }
+
+    static uint64_t _read_u64(const char *p)
+    {
+        return uint64_t(_read_u32(p)) | uint64_t(_read_u32(p + 4)) << 32;
+    }
+
+    static void _write_u32(string &out, uint32_t value)
+    {
+        for (int i = 0; i < 4; i++) out += static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+
+    static void _write_u64(string &out, uint64_t value)
+    {
+        _write_u32(out, static_cast<uint32_t>(value));
+        _write_u32(out, static_cast<uint32_t>(value >> 32));
+    }
+
+    bool sk_is_pack_file(const string &path)
+    {
+        char magic[sizeof(PACK_MAGIC)];
+
+        ifstream input(path, std::ios::binary);
+        if ( not input.read(magic, sizeof(magic)) ) return false;
+
+        return memcmp(magic, PACK_MAGIC, sizeof(PACK_MAGIC)) == 0;
+    }
+
+    // Maps the whole file read only, returning false if it cannot be mapped
+    static bool _map_pack_file(sk_pack *pack)
+    {
+#ifdef WINDOWS
+        HANDLE file = CreateFileA(pack->path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if ( file == INVALID_HANDLE_VALUE ) return false;
+
+        LARGE_INTEGER file_size;
+        if ( not GetFileSizeEx(file, &file_size) or file_size.QuadPart == 0 )
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if ( mapping == nullptr )
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        pack->data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if ( pack->data == nullptr )
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        pack->size = static_cast<size_t>(file_size.QuadPart);
+        pack->_file = file;
+        pack->_mapping = mapping;
+#else
+        int fd = open(pack->path.c_str(), O_RDONLY);
+        if ( fd < 0 ) return false;
+
+        struct stat info;
+        if ( fstat(fd, &info) != 0 or info.st_size == 0 )
+        {
+            close(fd);
+            return false;
+        }
+
+        void *mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        // the mapping stays valid once the file is closed
+        close(fd);
+        if ( mapped == MAP_FAILED ) return false;
+
+        // Resources are usually read front to back while a bundle loads
+        madvise(mapped, info.st_size, MADV_SEQUENTIAL);
+
+        pack->data = static_cast<const char *>(mapped);
+        pack->size = info.st_size;
+        pack->_file = nullptr;
+        pack->_mapping = nullptr;
+#endif
+        return true;
+    }
+
+    static void _unmap_pack_file(sk_pack *pack)
+    {
+        if ( pack->data == nullptr ) return;
+
+#ifdef WINDOWS
+        UnmapViewOfFile(pack->data);
+        CloseHandle(static_cast<HANDLE>(pack->_mapping));
+        CloseHandle(static_cast<HANDLE>(pack->_file));
+#else
+        munmap(const_cast<char *>(pack->data), pack->size);
+#endif
+        pack->data = nullptr;
+    }
+
+    // Reads the index at the end of the pack, returning false if it is not valid
+    static bool _read_pack_index(sk_pack *pack)
+    {
+        if ( pack->size < PACK_HEADER_SIZE or memcmp(pack->data, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0 )
+        {
+            LOG(WARNING) << "Not a resource pack: " << pack->path;
+            return false;
+        }
+
+        uint32_t version = _read_u32(pack->data + 8);
+        uint32_t count = _read_u32(pack->data + 12);
+        uint64_t index_offset = _read_u64(pack->data + 16);
+        uint64_t index_size = _read_u64(pack->data + 24);
+
+        if ( version != PACK_VERSION )
+        {
+            LOG(WARNING) << "Unsupported resource pack version " << version << " in " << pack->path;
+            return false;
+        }
+
+        if ( index_offset > pack->size or index_size > pack->size - index_offset )
+        {
+            LOG(WARNING) << "Resource pack index is outside the file in " << pack->path;
+            return false;
+        }
+
+        const char *p = pack->data + index_offset;
+        const char *end = p + index_size;
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if ( end - p < 4 )
+            {
+                LOG(WARNING) << "Resource pack index is truncated in " << pack->path;
+                return false;
+            }
+
+            uint32_t name_length = _read_u32(p);
+            p += 4;
+
+            // name, then compression, offset, stored size and size
+            if ( static_cast<uint64_t>(end - p) < uint64_t(name_length) + 28 )
+            {
+                LOG(WARNING) << "Resource pack index is truncated in " << pack->path;
+                return false;
+            }
+
+            sk_pack_entry entry;
+            entry.name.assign(p, name_length);
+            p += name_length;
+            entry.compression = static_cast<sk_pack_compression>(_read_u32(p));
+            entry.offset = _read_u64(p + 4);
+            entry.stored_size = _read_u64(p + 12);
+            entry.size = _read_u64(p + 20);
+            p += 28;
+
+            if ( entry.offset > pack->size or entry.stored_size > pack->size - entry.offset )
+            {
+                LOG(WARNING) << "Resource pack entry " << entry.name << " is outside the file in " << pack->path;
+                return false;
+            }
+
+            // The size is used to allocate the buffer the entry is read into
+            bool size_ok = true;
+            if ( entry.compression == SK_PACK_STORED )
+                size_ok = entry.size == entry.stored_size;
+            else if ( entry.compression == SK_PACK_ZLIB )
+                size_ok = entry.size <= entry.stored_size * PACK_MAX_ZLIB_RATIO and entry.size <= std::numeric_limits<uLongf>::max();
+
+            if ( not size_ok )
+            {
+                LOG(WARNING) << "Resource pack entry " << entry.name << " has an invalid size in " << pack->path;
+                return false;
+            }
+
+            pack->entries[entry.name] = entry;
+        }
+
+        return true;
+    }
+
+    sk_pack *sk_open_pack(const string &path)
+    {
+        sk_pack *pack = new sk_pack();
+        pack->path = path;
+        pack->data = nullptr;
+        pack->size = 0;
+
+        if ( not _map_pack_file(pack) )
+        {
+            LOG(WARNING) << "Unable to open resource pack " << path;
+            delete pack;
+            return nullptr;
+        }
+
+        if ( not _read_pack_index(pack) )
+        {
+            sk_close_pack(pack);
+            return nullptr;
+        }
+
+        return pack;
+    }
+
+    void sk_close_pack(sk_pack *pack)
+    {
+        if ( pack == nullptr ) return;
+
+        _unmap_pack_file(pack);
+        delete pack;
+    }
+
+    bool sk_pack_has_entry(const sk_pack *pack, const string &name)
+    {
+        return pack->entries.count(name) > 0;
+    }
+
+    bool sk_read_pack_entry(const sk_pack *pack, const string &name, const char *&data, size_t &size, vector<char> &buffer)
+    {
+        auto it = pack->entries.find(name);
+        if ( it == pack->entries.end() ) return false;
+
+        const sk_pack_entry &entry = it->second;
+        const char *stored = pack->data + entry.offset;
+
+        switch ( entry.compression )
+        {
+            case SK_PACK_STORED:
+                data = stored;
+                size = entry.stored_size;
+                return true;
+
+            case SK_PACK_ZLIB:
+            {
+                buffer.resize(entry.size);
+                uLongf inflated_size = static_cast<uLongf>(entry.size);
+
+                int status = uncompress(reinterpret_cast<Bytef *>(buffer.data()), &inflated_size,
+                                        reinterpret_cast<const Bytef *>(stored), static_cast<uLong>(entry.stored_size));
+
+                if ( status != Z_OK or inflated_size != entry.size )
+                {
+                    LOG(WARNING) << "Unable to decompress " << name << " from resource pack " << pack->path;
+                    return false;
+                }
+
+                data = buffer.data();
+                size = buffer.size();
+                return true;
+            }
+
+            default:
+                LOG(WARNING) << "Unknown compression for " << name << " in resource pack " << pack->path;
+                return false;
+        }
+    }
+
+    bool sk_write_pack(const string &path, const vector<string> &entry_names, const vector<string> &files, bool compress)
+    {
+        ofstream output(path, std::ios::binary);
+        if ( not output.is_open() )
+        {
+            LOG(WARNING) << "Unable to open " << path << " to write resource pack";
+            return false;
+        }
+
+        // The header is written again once the index location is known
+        output.write(string(PACK_HEADER_SIZE, '\0').data(), PACK_HEADER_SIZE);
+        uint64_t position = PACK_HEADER_SIZE;
+
+        string index;
+
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            ifstream input(files[i], std::ios::binary);
+            if ( not input.is_open() )
+            {
+                LOG(WARNING) << "Unable to read " << files[i] << " to add to resource pack";
+                return false;
+            }
+
+            string contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+            string stored;
+            sk_pack_compression compression = SK_PACK_STORED;
+
+            if ( compress and contents.size() > 0 )
+            {
+                uLongf compressed_size = compressBound(contents.size());
+                stored.resize(compressed_size);
+
+                int status = compress2(reinterpret_cast<Bytef *>(&stored[0]), &compressed_size,
+                                       reinterpret_cast<const Bytef *>(contents.data()), contents.size(), Z_BEST_COMPRESSION);
+
+                // Images and audio are often compressed already, so only keep worthwhile savings
+                if ( status == Z_OK and compressed_size < contents.size() - contents.size() / 8 )
+                {
+                    stored.resize(compressed_size);
+                    compression = SK_PACK_ZLIB;
+                }
+            }
+
+            if ( compression == SK_PACK_STORED ) stored.swap(contents);
+
+            size_t padding = (PACK_ALIGNMENT - position % PACK_ALIGNMENT) % PACK_ALIGNMENT;
+            output.write(string(padding, '\0').data(), padding);
+            position += padding;
+
+            _write_u32(index, static_cast<uint32_t>(entry_names[i].size()));
+            index += entry_names[i];
+            _write_u32(index, compression);
+            _write_u64(index, position);
+            _write_u64(index, stored.size());
+            _write_u64(index, compression == SK_PACK_STORED ? stored.size() : contents.size());
+
+            output.write(stored.data(), stored.size());
+            position += stored.size();
+        }
+
+        output.write(index.data(), index.size());
+
+        string header(PACK_MAGIC, sizeof(PACK_MAGIC));
+        _write_u32(header, PACK_VERSION);
+        _write_u32(header, static_cast<uint32_t>(files.size()));
+        _write_u64(header, position);
+        _write_u64(header, index.size());
+
+        output.seekp(0);
+        output.write(header.data(), header.size());
+
+        return output.good();
+    }
+}
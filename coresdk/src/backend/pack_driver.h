@@ -0,0 +1,87 @@
+//
+//  pack_driver.h
+//  splashkit
+//
+//  Reads and writes .skpak resource archives: a header, the entry data
+//  aligned to PACK_ALIGNMENT bytes, then an index of the entries. All
+//  numbers are stored little endian.
+//
+
+#ifndef splashkit_pack_driver_h
+#define splashkit_pack_driver_h
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+using std::string;
+using std::vector;
+
+namespace splashkit_lib
+{
+    enum sk_pack_compression
+    {
+        SK_PACK_STORED = 0,
+        SK_PACK_ZLIB = 1
+    };
+
+    struct sk_pack_entry
+    {
+        string name;
+        sk_pack_compression compression;
+        uint64_t offset;
+        uint64_t stored_size;
+        uint64_t size;
+    };
+
+    /**
+     * An open pack file. The file is memory mapped, so entries that are
+     * stored uncompressed are read directly from the mapping.
+     */
+    struct sk_pack
+    {
+        string path;
+        const char *data;
+        size_t size;
+        std::unordered_map<string, sk_pack_entry> entries;
+
+        // Handles for the mapping, used to close it
+        void *_file;
+        void *_mapping;
+    };
+
+    /**
+     * Returns true if the file at the path starts with the pack file header.
+     */
+    bool sk_is_pack_file(const string &path);
+
+    /**
+     * Maps the pack file into memory and reads its index. Returns nullptr if
+     * the file cannot be opened or is not a valid pack.
+     */
+    sk_pack *sk_open_pack(const string &path);
+
+    void sk_close_pack(sk_pack *pack);
+
+    bool sk_pack_has_entry(const sk_pack *pack, const string &name);
+
+    /**
+     * Reads the entry from the pack. Stored entries point straight into the
+     * mapped file, while compressed entries are inflated into buffer. The
+     * data remains valid until the pack is closed or the buffer changes.
+     * Safe to call from multiple threads at once. Returns false if the entry
+     * is missing or its data is corrupt.
+     */
+    bool sk_read_pack_entry(const sk_pack *pack, const string &name, const char *&data, size_t &size, vector<char> &buffer);
+
+    /**
+     * Writes a pack file containing each of the files, stored under the
+     * matching entry names. When compress is set, entries are stored with
+     * zlib if that makes them meaningfully smaller. Returns false if any
+     * file cannot be read or the pack cannot be written.
+     */
+    bool sk_write_pack(const string &path, const vector<string> &entry_names, const vector<string> &files, bool compress);
+}
+
+#endif /* splashkit_pack_driver_h */
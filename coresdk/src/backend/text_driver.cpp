@@ -63,17 +63,41 @@ namespace splashkit_lib
     {
         internal_sk_init();
 
-        sk_font_data *font = new sk_font_data;
+        sk_font_data *font = new_resource<sk_font_data>();
         font->id = FONT_PTR;
         font->filename = filename;
         font->was_downloaded = false;
+        font->_file_size = file_size(filename);
 
         sk_add_font_size(font, font_size);
 
         if ( font->_data.size() == 0 ) // failed to load font
         {
             font->id = NONE_PTR;
-            delete(font);
+            delete_resource(font);
+            font = nullptr;
+        }
+
+        return font;
+    }
+
+    sk_font_data* sk_load_font_from_memory(const char * data, unsigned long size, int font_size)
+    {
+        internal_sk_init();
+
+        sk_font_data *font = new_resource<sk_font_data>();
+        font->id = FONT_PTR;
+        font->filename = "";
+        font->was_downloaded = false;
+        font->_memory.assign(data, size);
+        font->_file_size = size;
+
+        sk_add_font_size(font, font_size);
+
+        if ( font->_data.size() == 0 ) // failed to load font
+        {
+            font->id = NONE_PTR;
+            delete_resource(font);
             font = nullptr;
         }
 
@@ -97,7 +121,10 @@ namespace splashkit_lib
             else
             {
                 // Load the font for the given size.
-                ttf_font = TTF_OpenFont(font->filename.c_str(), font_size);
+                if (font->_memory.length() > 0)
+                    ttf_font = TTF_OpenFontRW(SDL_RWFromConstMem(font->_memory.data(), static_cast<int>(font->_memory.length())), 1, font_size);
+                else
+                    ttf_font = TTF_OpenFont(font->filename.c_str(), font_size);
 
                 if (!ttf_font)
                 {
@@ -163,6 +190,23 @@ namespace splashkit_lib
         }
     }
 
+    bool sk_trim_font_sizes(sk_font_data* font)
+    {
+        if ( INVALID_PTR(font, FONT_PTR) or font->_data.size() <= 1 ) return false;
+
+        // Keep the first size, so the font's style is kept for the sizes opened later
+        for (auto it = std::next(font->_data.begin()); it != font->_data.end(); )
+        {
+            if (it->second)
+            {
+                TTF_CloseFont(static_cast<TTF_Font *>(it->second));
+            }
+            it = font->_data.erase(it);
+        }
+
+        return true;
+    }
+
     int sk_text_line_skip(sk_font_data* font, int font_size)
     {
         TTF_Font* ttf_font = _get_font(font, font_size);
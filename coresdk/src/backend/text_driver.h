@@ -17,9 +17,13 @@ namespace splashkit_lib
 
 
     sk_font_data* sk_load_font(const char * filename, int font_size);
+    sk_font_data* sk_load_font_from_memory(const char * data, unsigned long size, int font_size);
     void sk_add_font_size(sk_font_data *font, int font_size);
     bool sk_contains_valid_font(sk_font_data* font);
     void sk_close_font(sk_font_data* font);
+
+    // Closes all but one of the font's sizes, which are opened again when used. Returns false if only one size was open.
+    bool sk_trim_font_sizes(sk_font_data* font);
     int sk_text_line_skip(sk_font_data* font, int font_size);
     int sk_text_size(sk_font_data* font, int font_size, const string &text, int* w, int* h);
     void sk_set_font_style(sk_font_data* font, int font_size, int style);
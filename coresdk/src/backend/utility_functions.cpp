@@ -50,6 +50,13 @@ namespace splashkit_lib
         return (stat (path.c_str(), &buffer) == 0);
     }
 
+    unsigned long file_size(const string &path)
+    {
+        struct stat buffer;
+        if ( stat(path.c_str(), &buffer) != 0 ) return 0;
+        return static_cast<unsigned long>(buffer.st_size);
+    }
+
     bool directory_exists(const string path)
     {
         struct stat buffer;
@@ -166,10 +173,6 @@ namespace splashkit_lib
         return result;
     }
 
-    struct unknown_data {
-        pointer_identifier id;
-    };
-
     pointer_identifier ptr_kind(void *p)
     {
         unknown_data *ptr;
@@ -224,6 +227,7 @@ namespace splashkit_lib
         else if (id == BITMAP_PTR)
         {
             b = to_bitmap_ptr(p);
+            use_bitmap(b);
             return &b->image.surface;
         }
         else
@@ -10,10 +10,15 @@
 #define utility_functions_h
 
 #include "backend_types.h"
+#include "resources.h"
 
 #include <string>
 #include <initializer_list>
 #include <algorithm>
+#include <new>
+#include <memory>
+#include <deque>
+#include <unordered_map>
 
 #include <easylogging++.h>
 
@@ -30,6 +35,9 @@ namespace splashkit_lib
 
     bool directory_exists(string path);
 
+    // Returns the size of the file in bytes, or 0 if it does not exist.
+    unsigned long file_size(const string &path);
+
 #define VALID_PTR(p,pkind) ( (p) and p->id == pkind )
 #define INVALID_PTR(p,pkind) ( not VALID_PTR(p,pkind) )
 
@@ -126,6 +134,144 @@ collection.erase(collection.begin());\
 }
 
 
+    /**
+     * Adds the resource to the end of the collection, recording its index in
+     * the resource's slot so it can be removed later without a search.
+     */
+    template <typename T>
+    void add_to_slots(vector<T *> &collection, T *resource, size_t T::*slot)
+    {
+        resource->*slot = collection.size();
+        collection.push_back(resource);
+    }
+
+    /**
+     * Removes the resource from the collection by moving the last resource
+     * into its slot. Returns false if the resource is not in the collection.
+     */
+    template <typename T>
+    bool remove_from_slots(vector<T *> &collection, T *resource, size_t T::*slot)
+    {
+        size_t index = resource->*slot;
+        if (index >= collection.size() or collection[index] != resource) return false;
+
+        collection[index] = collection.back();
+        collection[index]->*slot = index;
+        collection.pop_back();
+        return true;
+    }
+
+    /**
+     * The leading identifier shared by every resource structure, used to check
+     * the kind of a pointer before it is used.
+     */
+    struct unknown_data {
+        pointer_identifier id;
+    };
+
+    /**
+     * Allocates resources of one kind from pages of slots that are never handed
+     * back to the heap. A freed slot keeps a NONE_PTR identifier until it is
+     * reused for another resource of the same kind, so checking a stale pointer
+     * with VALID_PTR reads valid memory and fails rather than reading freed memory.
+     *
+     * Once the slot is reused a stale pointer passes VALID_PTR again, as it now
+     * refers to the new resource. To make that less likely, freed slots are reused
+     * in the order they were freed, and a page is added whenever a page's worth of
+     * slots or fewer are free, so a freed slot waits behind the others.
+     */
+    template <typename T>
+    class resource_pool
+    {
+    private:
+        static const size_t SLOTS_PER_PAGE = 64;
+
+        union _slot
+        {
+            unknown_data freed;
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+
+        vector<std::unique_ptr<_slot[]>> _pages;
+        std::deque<_slot *> _free;
+
+        void _add_page()
+        {
+            _slot *page = new _slot[SLOTS_PER_PAGE];
+            _pages.push_back(std::unique_ptr<_slot[]>(page));
+
+            for (size_t i = 0; i < SLOTS_PER_PAGE; i++)
+            {
+                page[i].freed.id = NONE_PTR;
+                _free.push_back(&page[i]);
+            }
+        }
+
+    public:
+        T *allocate()
+        {
+            if (_free.size() <= SLOTS_PER_PAGE) _add_page();
+
+            _slot *slot = _free.front();
+            _free.pop_front();
+            return new (slot->storage) T();
+        }
+
+        void release(T *resource)
+        {
+            if (not resource) return;
+
+            resource->~T();
+            _slot *slot = reinterpret_cast<_slot *>(resource);
+            new (&slot->freed) unknown_data { NONE_PTR };
+            _free.push_back(slot);
+        }
+    };
+
+    // The pools live until the program exits, so resources can still be freed during shutdown.
+    template <typename T>
+    resource_pool<T> &_pool_for()
+    {
+        static resource_pool<T> *pool = new resource_pool<T>();
+        return *pool;
+    }
+
+    // Allocates a resource from the pool for its kind. Pair with delete_resource.
+    template <typename T>
+    T *new_resource()
+    {
+        return _pool_for<T>().allocate();
+    }
+
+    // Returns the resource's slot to its pool, leaving it marked as NONE_PTR.
+    template <typename T>
+    void delete_resource(T *resource)
+    {
+        _pool_for<T>().release(resource);
+    }
+
+    /**
+     * Returns the name if it is not in the collection, otherwise the name followed
+     * by the first unused number. The counters record the next number to try for each
+     * name, so creating many resources with the same name does not rescan the numbers
+     * already taken.
+     */
+    template <typename M>
+    string unique_name(const M &collection, std::unordered_map<string, int> &counters, const string &name)
+    {
+        if (collection.count(name) == 0) return name;
+
+        int &idx = counters[name];
+        string result;
+        do
+        {
+            result = name + std::to_string(idx);
+            idx++;
+        } while (collection.count(result) > 0);
+
+        return result;
+    }
+
     string cat(std::initializer_list<string> list);
 
     string path_from(std::initializer_list<string> list, string filename = string(""));
@@ -196,5 +342,42 @@ collection.erase(collection.begin());\
 
     // Notify the listeners that a resource has been freed. Implemented in resources.
     void notify_of_free(void *resource);
+
+    // Load resources from encoded data in memory. Implemented in images, sound, music, text and animations.
+    bitmap load_bitmap_from_memory(const string &name, const char *data, unsigned long size);
+    sound_effect load_sound_effect_from_memory(const string &name, const char *data, unsigned long size);
+    music load_music_from_memory(const string &name, const char *data, unsigned long size);
+    font load_font_from_memory(const string &name, const char *data, unsigned long size);
+    animation_script load_animation_script_from_memory(const string &name, const char *data, unsigned long size);
+
+    // Register resources decoded on a background thread. Implemented in images and sound.
+    bitmap _create_loaded_bitmap(const string &name, const string &file_path, const sk_drawing_surface &surface);
+    sound_effect _create_loaded_sound_effect(const string &name, const string &file_path, const struct sk_sound_data &effect);
+
+    // Finish loading the bundles being loaded in the background. Implemented in bundles.
+    void process_bundle_loads();
+
+    // Frees a resource's data so it can be loaded again from its file when next used,
+    // returning false if the resource must stay loaded.
+    typedef bool (resource_evictor)(void *resource);
+
+    // Memory accounting for loaded resources, evicting the least recently used resources
+    // of a kind when over its budget. Implemented in resources.
+    void track_resource_memory(resource_kind kind, void *resource, size_t bytes, resource_evictor *evict);
+    void untrack_resource_memory(resource_kind kind, void *resource);
+    void resource_used(resource_kind kind, void *resource);
+
+    // Locate resource files using an index of the resources folder, so most lookups need no
+    // file system checks. Return an empty string when the file cannot be found. The first
+    // only looks in the resources folder, the second also accepts the path as given. The
+    // third is for the *_named functions, which probe for a file on every lookup of an
+    // unknown name, so names that are not found are remembered until the resources path
+    // is set again. Implemented in resources.
+    string resource_file_path(const string &filename, resource_kind kind);
+    string find_resource_file(const string &filename, resource_kind kind);
+    bool has_resource_file(const string &name, resource_kind kind);
+
+    // Reloads the bitmap if it was evicted, and records its use. Implemented in images.
+    void use_bitmap(bitmap bmp);
 }
 #endif /* utility_functions_h */
@@ -16,21 +16,118 @@
 #include <string.h>
 
 #include <curl/curl.h>
+
+#include <mutex>
+#include <vector>
+#include <thread>
+#include <ctime>
+#include <fstream>
+#include <algorithm>
+#include <functional>
+#include <filesystem>
+#include <unordered_map>
+
+using std::mutex;
+using std::lock_guard;
+using std::ifstream;
+using std::ofstream;
+using std::unordered_map;
+using std::filesystem::directory_iterator;
+using std::filesystem::file_time_type;
+
 namespace splashkit_lib
 {
+    // Idle easy handles kept for reuse - each keeps its own live connections to recent hosts
+    static const size_t MAX_POOLED_CURL_HANDLES = 8;
+    static vector<CURL *> _curl_handle_pool;
+    static mutex _curl_handle_pool_lock;
+
+    // Shared between all handles, so DNS results, connections and TLS sessions are reused across requests
+    static CURLSH *_curl_share = nullptr;
+    static mutex _curl_share_locks[CURL_LOCK_DATA_LAST];
+
+    static void _lock_curl_share(CURL *handle, curl_lock_data data, curl_lock_access access, void *userptr)
+    {
+        _curl_share_locks[data].lock();
+    }
+
+    static void _unlock_curl_share(CURL *handle, curl_lock_data data, void *userptr)
+    {
+        _curl_share_locks[data].unlock();
+    }
+
+    // Buffers start at least this big, then double, so large bodies need few reallocs
+    static const unsigned long MIN_DOWNLOAD_BUFFER = 16 * 1024;
+
     struct request_stream
     {
         char *body;
         unsigned long at;
+        unsigned long capacity;
+
+        // Set to stream the body to a file or callback instead of buffering it
+        FILE *file;
+        http_data_callback *on_data;
+
+        CURL *curl_handle;
+
+        // Set to collect the response headers
+        vector<string> *headers;
     };
 
+    /*
+     * Ensures the body has room for at least `needed` bytes. Before the first
+     * chunk the Content-Length (if the server sent one) is used to allocate
+     * the whole body at once.
+     */
+    static bool _reserve_body(request_stream *mem, unsigned long needed)
+    {
+        if (needed <= mem->capacity) return true;
+
+        unsigned long new_capacity = MAX(mem->capacity * 2, MIN_DOWNLOAD_BUFFER);
+
+        if (mem->capacity == 0 and mem->curl_handle)
+        {
+#if LIBCURL_VERSION_NUM >= 0x073700
+            curl_off_t content_length = -1;
+            curl_easy_getinfo(mem->curl_handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &content_length);
+#else
+            double content_length = -1;
+            curl_easy_getinfo(mem->curl_handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &content_length);
+#endif
+            if (content_length > 0) new_capacity = static_cast<unsigned long>(content_length) + 1;
+        }
+
+        if (new_capacity < needed) new_capacity = needed;
+
+        char *body = (char *)realloc(mem->body, new_capacity);
+        if (body == NULL) return false;
+
+        mem->body = body;
+        mem->capacity = new_capacity;
+        return true;
+    }
+
     static size_t write_memory_callback(void *contents, size_t size, size_t nmemb, void *userp)
     {
         size_t realsize = size * nmemb;
         request_stream *mem = static_cast<request_stream *>(userp);
 
-        mem->body = (char *)realloc(mem->body, mem->at + realsize + 1);
-        if(mem->body == NULL) {
+        if (mem->file)
+        {
+            size_t written = fwrite(contents, 1, realsize, mem->file);
+            mem->at += written;
+            return written;
+        }
+
+        if (mem->on_data)
+        {
+            mem->on_data(string(static_cast<char *>(contents), realsize));
+            mem->at += realsize;
+            return realsize;
+        }
+
+        if (not _reserve_body(mem, mem->at + realsize + 1)) {
             /* out of memory! */
             LOG(ERROR) << "not enough memory (realloc returned NULL)";
             return 0;
@@ -43,6 +140,23 @@ namespace splashkit_lib
         return realsize;
     }
 
+    static size_t write_header_callback(char *buffer, size_t size, size_t nitems, void *userp)
+    {
+        size_t realsize = size * nitems;
+        request_stream *mem = static_cast<request_stream *>(userp);
+
+        string line(buffer, realsize);
+        while (line.length() > 0 and (line.back() == '\r' or line.back() == '\n')) line.pop_back();
+
+        // a status line starts a new response, so only the headers of the final response are kept after redirects
+        if (line.compare(0, 5, "HTTP/") == 0)
+            mem->headers->clear();
+        else if (line.length() > 0)
+            mem->headers->push_back(line);
+
+        return realsize;
+    }
+
     size_t write_data(void *ptr, size_t size, size_t nmemb, FILE *stream) {
         size_t written;
         written = fwrite(ptr, size, nmemb, stream);
@@ -80,13 +194,89 @@ namespace splashkit_lib
     void sk_init_web()
     {
         curl_global_init(CURL_GLOBAL_ALL);
+
+        _curl_share = curl_share_init();
+        if ( _curl_share )
+        {
+            curl_share_setopt(_curl_share, CURLSHOPT_LOCKFUNC, _lock_curl_share);
+            curl_share_setopt(_curl_share, CURLSHOPT_UNLOCKFUNC, _unlock_curl_share);
+            curl_share_setopt(_curl_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(_curl_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#if LIBCURL_VERSION_NUM >= 0x073900
+            curl_share_setopt(_curl_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+        }
     }
 
+    static void _stop_request_thread();
+
     void sk_finalise_web()
     {
+        // The request thread uses the handle pool and curl itself, so stop it first
+        _stop_request_thread();
+
+        {
+            lock_guard<mutex> lock(_curl_handle_pool_lock);
+            for (CURL *curl_handle : _curl_handle_pool)
+            {
+                curl_easy_cleanup(curl_handle);
+            }
+            _curl_handle_pool.clear();
+        }
+
+        if ( _curl_share )
+        {
+            curl_share_cleanup(_curl_share);
+            _curl_share = nullptr;
+        }
+
         curl_global_cleanup();
     }
 
+    /**
+     * Returns an easy handle from the pool, or a new one if none are idle.
+     * Pooled handles have been reset, so all options need to be set again.
+     */
+    CURL *_acquire_curl_handle()
+    {
+        CURL *curl_handle = nullptr;
+
+        {
+            lock_guard<mutex> lock(_curl_handle_pool_lock);
+            if ( _curl_handle_pool.size() > 0 )
+            {
+                curl_handle = _curl_handle_pool.back();
+                _curl_handle_pool.pop_back();
+            }
+        }
+
+        if ( not curl_handle )
+        {
+            curl_handle = curl_easy_init();
+        }
+
+        return curl_handle;
+    }
+
+    /**
+     * Returns the handle to the pool. curl_easy_reset clears the options
+     * but keeps the handle's live connections and caches.
+     */
+    void _release_curl_handle(CURL *curl_handle)
+    {
+        curl_easy_reset(curl_handle);
+
+        lock_guard<mutex> lock(_curl_handle_pool_lock);
+        if ( _curl_handle_pool.size() < MAX_POOLED_CURL_HANDLES )
+        {
+            _curl_handle_pool.push_back(curl_handle);
+        }
+        else
+        {
+            curl_easy_cleanup(curl_handle);
+        }
+    }
+
     void _init_curl(CURL *curl_handle, const string &host, unsigned short port)
     {
         // specify URL to get
@@ -99,11 +289,16 @@ namespace splashkit_lib
 
         curl_easy_setopt(curl_handle, CURLOPT_SSL_VERIFYPEER, 0L);
 
+        // share caches with other handles, and keep idle connections alive for reuse
+        if ( _curl_share )
+            curl_easy_setopt(curl_handle, CURLOPT_SHARE, _curl_share);
+        curl_easy_setopt(curl_handle, CURLOPT_TCP_KEEPALIVE, 1L);
+
         // some servers don't like requests that are made without a user-agent field, so we provide one
         curl_easy_setopt(curl_handle, CURLOPT_USERAGENT, "libcurl-agent/1.0");
     }
 
-    struct curl_slist *_setup_curl_upload(CURL *curl_handle, const string &body, const vector<string> &headers)
+    struct curl_slist *_setup_curl_headers(CURL *curl_handle, const vector<string> &headers)
     {
         // header list
         struct curl_slist *list = NULL;
@@ -122,6 +317,13 @@ namespace splashkit_lib
         }
 
         curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, list);
+
+        return list;
+    }
+
+    struct curl_slist *_setup_curl_upload(CURL *curl_handle, const string &body, const vector<string> &headers)
+    {
+        struct curl_slist *list = _setup_curl_headers(curl_handle, headers);
         curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDS, body.c_str());
 
         return list;
@@ -134,6 +336,15 @@ namespace splashkit_lib
 
         // pass in the result as the location to write to
         curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, (void *)result);
+
+        // used to read the Content-Length when the body is first allocated
+        result->curl_handle = curl_handle;
+
+        if (result->headers)
+        {
+            curl_easy_setopt(curl_handle, CURLOPT_HEADERFUNCTION, write_header_callback);
+            curl_easy_setopt(curl_handle, CURLOPT_HEADERDATA, (void *)result);
+        }
     }
 
     sk_http_response *_create_response(CURL *curl_handle, CURLcode res, request_stream &data)
@@ -142,6 +353,8 @@ namespace splashkit_lib
         if(res != CURLE_OK)
         {
             LOG(ERROR) << curl_easy_strerror(res);
+            _release_curl_handle(curl_handle);
+            free(data.body);
             return nullptr;
         }
 
@@ -160,8 +373,21 @@ namespace splashkit_lib
         else
             result->content_type = "";
 
-        /* cleanup curl stuff */
-        curl_easy_cleanup(curl_handle);
+        /* return the handle, and its connection, to the pool */
+        _release_curl_handle(curl_handle);
+
+        if (data.body == nullptr)
+        {
+            // nothing was buffered - either an empty body or it was streamed elsewhere
+            data.body = (char *)calloc(1, 1);
+            data.at = 0;
+        }
+        else if (data.capacity > data.at + 1 + data.at / 4)
+        {
+            // give back the unused space from doubling the buffer
+            char *body = (char *)realloc(data.body, data.at + 1);
+            if (body) data.body = body;
+        }
 
         result->message = data.body;
         result->message_size = data.at;
@@ -173,7 +399,7 @@ namespace splashkit_lib
         request_stream data_read = { nullptr, 0 };
 
         // init the curl session
-        CURL *curl_handle = curl_easy_init();;
+        CURL *curl_handle = _acquire_curl_handle();
         CURLcode res;
 
         _init_curl(curl_handle, host, port);
@@ -189,29 +415,562 @@ namespace splashkit_lib
         return _create_response(curl_handle, res, data_read);
     }
 
-    sk_http_response *sk_http_get(const string &host, unsigned short port)
+    static sk_http_response *_http_get(const string &host, unsigned short port, request_stream &data_read, struct curl_slist *list = nullptr)
     {
-        request_stream data_read = { nullptr, 0 };
-
         // init the curl session
-        CURL *curl_handle = curl_easy_init();;
+        CURL *curl_handle = _acquire_curl_handle();
         CURLcode res;
 
         _init_curl(curl_handle, host, port);
         _setup_curl_download(curl_handle, &data_read);
 
+        if (list)
+            curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, list);
+
         // get it!
         res = curl_easy_perform(curl_handle);
 
         return _create_response(curl_handle, res, data_read);
     }
 
+    // Details of a response saved in the http cache. The body is in <name>.body and these details in <name>.meta
+    struct _http_cache_entry
+    {
+        string          key;
+        string          etag;
+        string          last_modified;
+        string          content_type;
+        time_t          expires;        // fresh until this time, 0 to revalidate on every use
+        unsigned long   size;
+        unsigned long   last_used;
+    };
+
+    // The cache is disabled while the directory is empty. Entries are indexed by file name.
+    // The lock guards the index - the cache files are read and written without holding it.
+    static mutex _http_cache_lock;
+    static string _http_cache_dir;
+    static unsigned long _http_cache_limit = 0;
+    static unsigned long _http_cache_used = 0;
+    static unsigned long _http_cache_clock = 0;
+    static unordered_map<string, _http_cache_entry> _http_cache;
+
+    static string _http_cache_name(const string &key)
+    {
+        char name[17];
+        snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(std::hash<string>{}(key)));
+        return string(name);
+    }
+
+    static string _http_cache_path(const string &dir, const string &name, const string &extension)
+    {
+        return (std::filesystem::path(dir) / (name + extension)).string();
+    }
+
+    // Files are written under a name unique to the thread, then moved into place
+    static string _http_cache_temp_path(const string &dir, const string &name, const string &extension)
+    {
+        size_t thread_id = std::hash<std::thread::id>{}(std::this_thread::get_id());
+        return _http_cache_path(dir, name, extension + "." + std::to_string(thread_id) + ".tmp");
+    }
+
+    static void _save_http_cache_meta(const string &path, const _http_cache_entry &entry)
+    {
+        ofstream meta(path);
+        meta << "key: " << entry.key << "\n"
+             << "etag: " << entry.etag << "\n"
+             << "last-modified: " << entry.last_modified << "\n"
+             << "content-type: " << entry.content_type << "\n"
+             << "expires: " << entry.expires << "\n";
+    }
+
+    static bool _load_http_cache_meta(const string &path, _http_cache_entry &entry)
+    {
+        ifstream meta(path);
+        if ( not meta ) return false;
+
+        string line;
+        while ( getline(meta, line) )
+        {
+            size_t sep = line.find(": ");
+            if ( sep == string::npos ) continue;
+
+            string field = line.substr(0, sep);
+            string value = line.substr(sep + 2);
+
+            if ( field == "key" ) entry.key = value;
+            else if ( field == "etag" ) entry.etag = value;
+            else if ( field == "last-modified" ) entry.last_modified = value;
+            else if ( field == "content-type" ) entry.content_type = value;
+            else if ( field == "expires" ) entry.expires = static_cast<time_t>(atoll(value.c_str()));
+        }
+
+        return entry.key.length() > 0;
+    }
+
+    static void _delete_http_cache_files(const string &dir, const vector<string> &names)
+    {
+        std::error_code err;
+        for (const string &name : names)
+        {
+            std::filesystem::remove(_http_cache_path(dir, name, ".body"), err);
+            std::filesystem::remove(_http_cache_path(dir, name, ".meta"), err);
+        }
+    }
+
+    // The _http_cache_lock must be held by the caller of the functions that change the index.
+    // The files of removed entries are deleted by the caller once it has released the lock.
+    static bool _remove_http_cache_entry(const string &name)
+    {
+        auto it = _http_cache.find(name);
+        if ( it == _http_cache.end() ) return false;
+
+        _http_cache_used -= it->second.size;
+        _http_cache.erase(it);
+        return true;
+    }
+
+    /**
+     * Removes the least recently used entries until there is room for
+     * `needed` more bytes, adding their names to `removed`. Files in the
+     * directory that are not in the index, such as a body left without its
+     * details, are added as well - they use space without being counted.
+     */
+    static void _evict_http_cache(unsigned long needed, vector<string> &removed)
+    {
+        if ( _http_cache_used + needed <= _http_cache_limit ) return;
+
+        std::error_code err;
+        for (const auto &file : directory_iterator(_http_cache_dir, err))
+        {
+            string extension = file.path().extension().string();
+            if ( extension != ".body" and extension != ".meta" ) continue;
+
+            string name = file.path().stem().string();
+            if ( _http_cache.count(name) == 0 and std::find(removed.begin(), removed.end(), name) == removed.end() )
+                removed.push_back(name);
+        }
+
+        while ( _http_cache.size() > 0 and _http_cache_used + needed > _http_cache_limit )
+        {
+            auto oldest = std::min_element(_http_cache.begin(), _http_cache.end(),
+                [] (const auto &a, const auto &b) { return a.second.last_used < b.second.last_used; });
+
+            removed.push_back(oldest->first);
+            _remove_http_cache_entry(oldest->first);
+        }
+    }
+
+    /**
+     * Removes the entry from the index, and deletes its files, if it is still
+     * in the cache at `dir`.
+     */
+    static void _discard_http_cache_entry(const string &dir, const string &name)
+    {
+        {
+            lock_guard<mutex> lock(_http_cache_lock);
+            if ( dir != _http_cache_dir or not _remove_http_cache_entry(name) ) return;
+        }
+
+        _delete_http_cache_files(dir, { name });
+    }
+
+    static sk_http_response *_read_http_cache(const string &dir, const string &name, const _http_cache_entry &entry)
+    {
+        string body_path = _http_cache_path(dir, name, ".body");
+
+        FILE *file = fopen(body_path.c_str(), "rb");
+        if ( not file ) return nullptr;
+
+        char *body = (char *)malloc(entry.size + 1);
+        size_t read = body ? fread(body, 1, entry.size, file) : 0;
+        fclose(file);
+
+        if ( not body or read != entry.size )
+        {
+            free(body);
+            return nullptr;
+        }
+        body[entry.size] = 0;
+
+        // the body's modified time records when it was used, so the order survives restarts
+        std::error_code err;
+        std::filesystem::last_write_time(body_path, file_time_type::clock::now(), err);
+
+        sk_http_response *result = new sk_http_response;
+        result->id = HTTP_RESPONSE_PTR;
+        result->code = HTTP_STATUS_OK;
+        result->content_type = entry.content_type;
+        result->message = body;
+        result->message_size = entry.size;
+        return result;
+    }
+
+    /**
+     * Stores the response in the cache at `dir`. The files are written under
+     * temporary names, then moved into place as the entry is indexed, so
+     * readers never see a partly written body.
+     */
+    static void _write_http_cache(const string &dir, const string &name, _http_cache_entry entry, const sk_http_response *response)
+    {
+        {
+            lock_guard<mutex> lock(_http_cache_lock);
+            if ( dir != _http_cache_dir or response->message_size > _http_cache_limit ) return;
+        }
+
+        entry.content_type = response->content_type;
+        entry.size = response->message_size;
+
+        string body_temp = _http_cache_temp_path(dir, name, ".body");
+        string meta_temp = _http_cache_temp_path(dir, name, ".meta");
+
+        FILE *file = fopen(body_temp.c_str(), "wb");
+        if ( not file )
+        {
+            LOG(WARNING) << "Unable to write to the http cache at " << body_temp;
+            return;
+        }
+
+        size_t written = fwrite(response->message, 1, response->message_size, file);
+        fclose(file);
+
+        std::error_code err;
+        if ( written != response->message_size )
+        {
+            std::filesystem::remove(body_temp, err);
+            return;
+        }
+
+        _save_http_cache_meta(meta_temp, entry);
+
+        vector<string> removed;
+        bool stored = false;
+        {
+            lock_guard<mutex> lock(_http_cache_lock);
+            if ( dir == _http_cache_dir )
+            {
+                _remove_http_cache_entry(name);
+                _evict_http_cache(entry.size, removed);
+
+                // the old files for this entry are replaced, not deleted
+                removed.erase(std::remove(removed.begin(), removed.end(), name), removed.end());
+
+                std::error_code body_err, meta_err;
+                std::filesystem::rename(body_temp, _http_cache_path(dir, name, ".body"), body_err);
+                std::filesystem::rename(meta_temp, _http_cache_path(dir, name, ".meta"), meta_err);
+
+                if ( not body_err and not meta_err )
+                {
+                    entry.last_used = ++_http_cache_clock;
+                    _http_cache[name] = entry;
+                    _http_cache_used += entry.size;
+                    stored = true;
+                }
+                else
+                {
+                    removed.push_back(name);
+                }
+            }
+        }
+
+        if ( not stored )
+        {
+            std::filesystem::remove(body_temp, err);
+            std::filesystem::remove(meta_temp, err);
+        }
+
+        _delete_http_cache_files(dir, removed);
+    }
+
+    static string _response_header(const vector<string> &headers, const string &name)
+    {
+        for (const string &header : headers)
+        {
+            size_t colon = header.find(':');
+            if ( colon != string::npos and to_lower(trim(header.substr(0, colon))) == name )
+                return trim(header.substr(colon + 1));
+        }
+        return "";
+    }
+
+    /**
+     * Reads the Cache-Control header to find how long the response stays
+     * fresh. Returns false if the response must not be stored.
+     */
+    static bool _read_cache_control(const vector<string> &headers, time_t &expires)
+    {
+        string cache_control = to_lower(_response_header(headers, "cache-control"));
+
+        expires = 0;
+        if ( cache_control.find("no-store") != string::npos ) return false;
+        if ( cache_control.find("no-cache") != string::npos ) return true;
+
+        size_t max_age = cache_control.find("max-age=");
+        if ( max_age != string::npos )
+            expires = time(nullptr) + atol(cache_control.c_str() + max_age + 8);
+
+        return true;
+    }
+
+    static bool _http_cache_enabled()
+    {
+        lock_guard<mutex> lock(_http_cache_lock);
+        return _http_cache_dir.length() > 0;
+    }
+
+    static sk_http_response *_cached_http_get(const string &host, unsigned short port)
+    {
+        string key = host + ":" + std::to_string(port);
+        string name = _http_cache_name(key);
+        string dir;
+
+        _http_cache_entry entry;
+        bool have_entry = false;
+        bool fresh = false;
+
+        {
+            lock_guard<mutex> lock(_http_cache_lock);
+            dir = _http_cache_dir;
+
+            auto it = _http_cache.find(name);
+            if ( it != _http_cache.end() and it->second.key == key )
+            {
+                entry = it->second;
+                fresh = entry.expires > time(nullptr);
+                have_entry = not fresh;
+
+                if ( fresh ) it->second.last_used = ++_http_cache_clock;
+            }
+        }
+
+        if ( fresh )
+        {
+            sk_http_response *result = _read_http_cache(dir, name, entry);
+            if ( result ) return result;
+            _discard_http_cache_entry(dir, name);
+        }
+
+        // ask the server to only send the body if it has changed since it was stored
+        struct curl_slist *list = NULL;
+        if ( have_entry and entry.etag.length() > 0 )
+            list = curl_slist_append(list, ("If-None-Match: " + entry.etag).c_str());
+        if ( have_entry and entry.last_modified.length() > 0 )
+            list = curl_slist_append(list, ("If-Modified-Since: " + entry.last_modified).c_str());
+
+        vector<string> headers;
+        request_stream data_read = { nullptr, 0 };
+        data_read.headers = &headers;
+
+        sk_http_response *result = _http_get(host, port, data_read, list);
+        curl_slist_free_all(list);
+
+        if ( not result or dir.length() == 0 ) return result;
+
+        time_t expires;
+        bool storable = _read_cache_control(headers, expires);
+        string etag = _response_header(headers, "etag");
+        string last_modified = _response_header(headers, "last-modified");
+
+        if ( result->code == HTTP_STATUS_NOT_MODIFIED and have_entry )
+        {
+            bool still_cached = false;
+            {
+                lock_guard<mutex> lock(_http_cache_lock);
+
+                auto it = _http_cache.find(name);
+                if ( dir == _http_cache_dir and it != _http_cache.end() and it->second.key == key )
+                {
+                    // unchanged - extend the stored entry and reply with its body
+                    it->second.expires = expires;
+                    if ( etag.length() > 0 ) it->second.etag = etag;
+                    if ( last_modified.length() > 0 ) it->second.last_modified = last_modified;
+                    it->second.last_used = ++_http_cache_clock;
+
+                    entry = it->second;
+                    still_cached = true;
+                }
+            }
+
+            if ( still_cached )
+            {
+                _save_http_cache_meta(_http_cache_path(dir, name, ".meta"), entry);
+
+                sk_http_response *cached = _read_http_cache(dir, name, entry);
+                if ( cached )
+                {
+                    free_response(result);
+                    return cached;
+                }
+                _discard_http_cache_entry(dir, name);
+            }
+        }
+        else
+        {
+            // without a validator or max-age the entry could never be reused
+            if ( result->code == HTTP_STATUS_OK and storable and
+                 (etag.length() > 0 or last_modified.length() > 0 or expires > time(nullptr)) )
+            {
+                _http_cache_entry stored = { key, etag, last_modified, "", expires, 0, 0 };
+                _write_http_cache(dir, name, stored, result);
+            }
+            return result;
+        }
+
+        // the entry was removed while being revalidated, so get the whole body again
+        free_response(result);
+        request_stream retry_read = { nullptr, 0 };
+        return _http_get(host, port, retry_read);
+    }
+
+    void sk_enable_http_cache(const string &directory, unsigned long max_bytes)
+    {
+        sk_disable_http_cache();
+
+        std::error_code err;
+        std::filesystem::create_directories(directory, err);
+        if ( err )
+        {
+            LOG(WARNING) << "Unable to create the http cache directory " << directory;
+            return;
+        }
+
+        // index the entries already on disk, removing files left without their partner
+        // and temporary files from stores that never finished
+        unordered_map<string, _http_cache_entry> found;
+        vector<std::pair<file_time_type, string>> by_use;
+        vector<string> orphans;
+        unsigned long used = 0;
+
+        for (const auto &file : directory_iterator(directory, err))
+        {
+            string extension = file.path().extension().string();
+            string name = file.path().stem().string();
+
+            if ( extension == ".tmp" )
+            {
+                std::error_code remove_err;
+                std::filesystem::remove(file.path(), remove_err);
+                continue;
+            }
+
+            if ( extension == ".meta" )
+            {
+                if ( not file_exists(_http_cache_path(directory, name, ".body")) ) orphans.push_back(name);
+                continue;
+            }
+
+            if ( extension != ".body" ) continue;
+
+            _http_cache_entry entry = { "", "", "", "", 0, 0, 0 };
+            if ( not _load_http_cache_meta(_http_cache_path(directory, name, ".meta"), entry) )
+            {
+                orphans.push_back(name);
+                continue;
+            }
+
+            entry.size = static_cast<unsigned long>(file.file_size(err));
+            found[name] = entry;
+            used += entry.size;
+            by_use.push_back({ file.last_write_time(err), name });
+        }
+
+        _delete_http_cache_files(directory, orphans);
+
+        // order the entries by when their bodies were last used
+        std::sort(by_use.begin(), by_use.end());
+        unsigned long clock = 0;
+        for (const auto &item : by_use)
+        {
+            found[item.second].last_used = ++clock;
+        }
+
+        vector<string> removed;
+        {
+            lock_guard<mutex> lock(_http_cache_lock);
+
+            _http_cache.swap(found);
+            _http_cache_dir = directory;
+            _http_cache_limit = max_bytes;
+            _http_cache_used = used;
+            _http_cache_clock = clock;
+
+            _evict_http_cache(0, removed);
+        }
+
+        _delete_http_cache_files(directory, removed);
+    }
+
+    void sk_disable_http_cache()
+    {
+        lock_guard<mutex> lock(_http_cache_lock);
+
+        _http_cache.clear();
+        _http_cache_dir = "";
+        _http_cache_used = 0;
+        _http_cache_clock = 0;
+    }
+
+    void sk_clear_http_cache()
+    {
+        string dir;
+        vector<string> removed;
+
+        {
+            lock_guard<mutex> lock(_http_cache_lock);
+            dir = _http_cache_dir;
+
+            for (const auto &item : _http_cache)
+            {
+                removed.push_back(item.first);
+            }
+            _http_cache.clear();
+            _http_cache_used = 0;
+        }
+
+        if ( dir.length() > 0 ) _delete_http_cache_files(dir, removed);
+    }
+
+    sk_http_response *sk_http_get(const string &host, unsigned short port)
+    {
+        if ( _http_cache_enabled() )
+            return _cached_http_get(host, port);
+
+        request_stream data_read = { nullptr, 0 };
+        return _http_get(host, port, data_read);
+    }
+
+    sk_http_response *sk_http_get_to_file(const string &host, unsigned short port, FILE *file)
+    {
+        if ( _http_cache_enabled() )
+        {
+            sk_http_response *result = _cached_http_get(host, port);
+            if ( not result ) return nullptr;
+
+            // copy the body to the file, leaving the response empty as for a streamed download
+            fwrite(result->message, 1, result->message_size, file);
+            free(result->message);
+            result->message = (char *)calloc(1, 1);
+            result->message_size = 0;
+            return result;
+        }
+
+        request_stream data_read = { nullptr, 0 };
+        data_read.file = file;
+        return _http_get(host, port, data_read);
+    }
+
+    sk_http_response *sk_http_get_streamed(const string &host, unsigned short port, http_data_callback *on_data)
+    {
+        request_stream data_read = { nullptr, 0 };
+        data_read.on_data = on_data;
+        return _http_get(host, port, data_read);
+    }
+
     sk_http_response *sk_http_put(const string &host, unsigned short port, const string &body)
     {
         request_stream data_read = { nullptr, 0 };
 
         // init the curl session
-        CURL *curl_handle = curl_easy_init();;
+        CURL *curl_handle = _acquire_curl_handle();
         CURLcode res;
 
         _init_curl(curl_handle, host, port);
@@ -253,7 +1012,7 @@ namespace splashkit_lib
         request_stream data_read = { nullptr, 0 };
 
         // init the curl session
-        CURL *curl_handle = curl_easy_init();;
+        CURL *curl_handle = _acquire_curl_handle();
         CURLcode res;
 
 
@@ -291,4 +1050,314 @@ namespace splashkit_lib
                 return nullptr;
         }
     }
+
+    // Per transfer curl state for a pending request
+    struct _async_transfer
+    {
+        CURL                *curl_handle;
+        request_stream      download;
+        request_stream      upload;
+        struct curl_slist   *list;
+    };
+
+    static CURLM *_curl_multi = nullptr;
+    static mutex _request_thread_lock;
+
+    // New requests for the request thread, and finished requests waiting for their callback.
+    // A null request asks the request thread to stop. Channels never block when putting, so
+    // the request thread keeps running however long the callbacks wait for process_events.
+    static channel<sk_pending_request *> _async_request_queue;
+    static channel<sk_pending_request *> _completed_callback_queue;
+
+    // Joins the request thread at exit if sk_finalise_web was not called. Declared after
+    // the queues, so the thread has stopped before they are destroyed.
+    static struct _request_thread_owner
+    {
+        thread worker;
+        ~_request_thread_owner();
+    } _request_thread;
+
+    static void _delete_pending_request(sk_pending_request *request)
+    {
+        if ( VALID_PTR(request->response, HTTP_RESPONSE_PTR) )
+        {
+            free_response(request->response);
+        }
+
+        request->id = NONE_PTR;
+        delete request;
+    }
+
+    /**
+     * Records the result of the request, then wakes anyone waiting for it
+     * and queues its callback.
+     */
+    static void _complete_pending_request(sk_pending_request *request, sk_http_response *response)
+    {
+        bool delete_now;
+        bool queue_callback;
+
+        {
+            lock_guard<mutex> lock(request->lock);
+            request->response = response;
+            request->complete = true;
+
+            queue_callback = request->on_complete and not request->released;
+            request->callback_pending = queue_callback;
+            delete_now = request->released and not queue_callback;
+        }
+
+        request->finished.notify_all();
+
+        if ( queue_callback ) _completed_callback_queue.put(request);
+        if ( delete_now ) _delete_pending_request(request);
+    }
+
+    /**
+     * Adds the request's transfer to the multi handle, returning false if it
+     * could not be started and has already been completed.
+     */
+    static bool _start_async_transfer(sk_pending_request *request)
+    {
+        _async_transfer *transfer = new _async_transfer { _acquire_curl_handle(), { nullptr, 0 }, { nullptr, 0 }, nullptr };
+        CURL *curl_handle = transfer->curl_handle;
+
+        if ( not curl_handle )
+        {
+            delete transfer;
+            _complete_pending_request(request, nullptr);
+            return false;
+        }
+
+        request->_transfer = transfer;
+
+        _init_curl(curl_handle, request->uri, request->port);
+        _setup_curl_download(curl_handle, &transfer->download);
+
+        switch (request->method)
+        {
+            case HTTP_POST_METHOD:
+                transfer->list = _setup_curl_upload(curl_handle, request->body, request->headers);
+                break;
+            case HTTP_PUT_METHOD:
+                transfer->list = _setup_curl_headers(curl_handle, request->headers);
+                transfer->upload.body = strdup(request->body.c_str());
+                curl_easy_setopt(curl_handle, CURLOPT_READFUNCTION, read_request_body);
+                curl_easy_setopt(curl_handle, CURLOPT_UPLOAD, 1L);
+                curl_easy_setopt(curl_handle, CURLOPT_READDATA, &transfer->upload);
+                curl_easy_setopt(curl_handle, CURLOPT_INFILESIZE, (curl_off_t)request->body.length());
+                break;
+            case HTTP_DELETE_METHOD:
+                transfer->list = _setup_curl_upload(curl_handle, request->body, request->headers);
+                curl_easy_setopt(curl_handle, CURLOPT_CUSTOMREQUEST, "DELETE");
+                break;
+            default:
+                break;
+        }
+
+        curl_easy_setopt(curl_handle, CURLOPT_PRIVATE, request);
+        curl_multi_add_handle(_curl_multi, curl_handle);
+        return true;
+    }
+
+    static void _finish_async_transfer(sk_pending_request *request, CURLcode res)
+    {
+        _async_transfer *transfer = static_cast<_async_transfer *>(request->_transfer);
+        request->_transfer = nullptr;
+
+        curl_multi_remove_handle(_curl_multi, transfer->curl_handle);
+
+        sk_http_response *response = _create_response(transfer->curl_handle, res, transfer->download);
+
+        curl_slist_free_all(transfer->list);
+        free(transfer->upload.body);
+        delete transfer;
+
+        _complete_pending_request(request, response);
+    }
+
+    /**
+     * Stops a transfer that is still running, completing its request without a response.
+     */
+    static void _abandon_async_transfer(sk_pending_request *request)
+    {
+        _async_transfer *transfer = static_cast<_async_transfer *>(request->_transfer);
+        request->_transfer = nullptr;
+
+        curl_multi_remove_handle(_curl_multi, transfer->curl_handle);
+        _release_curl_handle(transfer->curl_handle);
+
+        curl_slist_free_all(transfer->list);
+        free(transfer->download.body);
+        free(transfer->upload.body);
+        delete transfer;
+
+        _complete_pending_request(request, nullptr);
+    }
+
+    /**
+     * Runs all of the async transfers. The thread sleeps on the request queue
+     * when idle, and in curl's poll while transfers are in flight. It exits
+     * when it takes a null request, abandoning any transfers still running.
+     */
+    static void _request_thread_loop()
+    {
+        vector<sk_pending_request *> in_flight;
+        bool stopping = false;
+
+        while ( not stopping )
+        {
+            sk_pending_request *request;
+
+            if ( in_flight.empty() )
+            {
+                request = _async_request_queue.take();
+                if ( not request ) break;
+                if ( _start_async_transfer(request) ) in_flight.push_back(request);
+            }
+
+            while (_async_request_queue.try_take(request))
+            {
+                if ( not request )
+                {
+                    stopping = true;
+                    break;
+                }
+                if ( _start_async_transfer(request) ) in_flight.push_back(request);
+            }
+
+            if ( stopping ) break;
+
+            int running;
+            curl_multi_perform(_curl_multi, &running);
+
+            CURLMsg *msg;
+            int remaining;
+            while ((msg = curl_multi_info_read(_curl_multi, &remaining)))
+            {
+                if ( msg->msg != CURLMSG_DONE ) continue;
+
+                // read these before the handle is removed, which invalidates msg
+                CURL *curl_handle = msg->easy_handle;
+                CURLcode res = msg->data.result;
+
+                curl_easy_getinfo(curl_handle, CURLINFO_PRIVATE, &request);
+                erase_from_vector(in_flight, request);
+                _finish_async_transfer(request, res);
+            }
+
+            if ( running > 0 )
+            {
+#if LIBCURL_VERSION_NUM >= 0x074400
+                // sleeps until there is socket activity, or sk_http_make_request_async wakes us
+                curl_multi_poll(_curl_multi, nullptr, 0, 1000, nullptr);
+#else
+                // without curl_multi_wakeup keep the timeout short, so new requests start promptly
+                curl_multi_wait(_curl_multi, nullptr, 0, 10, nullptr);
+#endif
+            }
+        }
+
+        for (sk_pending_request *abandoned : in_flight)
+        {
+            _abandon_async_transfer(abandoned);
+        }
+    }
+
+    static void _stop_request_thread()
+    {
+        lock_guard<mutex> lock(_request_thread_lock);
+        if ( not _request_thread.worker.joinable() ) return;
+
+        _async_request_queue.put(nullptr);
+#if LIBCURL_VERSION_NUM >= 0x074400
+        curl_multi_wakeup(_curl_multi);
+#endif
+        _request_thread.worker.join();
+
+        // Requests made while the thread was stopping never started
+        sk_pending_request *request;
+        while (_async_request_queue.try_take(request))
+        {
+            if ( request ) _complete_pending_request(request, nullptr);
+        }
+
+        curl_multi_cleanup(_curl_multi);
+        _curl_multi = nullptr;
+    }
+
+    _request_thread_owner::~_request_thread_owner()
+    {
+        _stop_request_thread();
+    }
+
+    void sk_http_make_request_async(sk_pending_request *request)
+    {
+        internal_sk_init();
+
+        request->_transfer = nullptr;
+        request->complete = false;
+        request->released = false;
+        request->callback_pending = false;
+        request->response = nullptr;
+
+        // Under the lock, so the multi handle cannot be cleaned up by _stop_request_thread while waking it
+        lock_guard<mutex> lock(_request_thread_lock);
+        if ( not _request_thread.worker.joinable() )
+        {
+            _curl_multi = curl_multi_init();
+            _request_thread.worker = thread(_request_thread_loop);
+        }
+
+        _async_request_queue.put(request);
+
+#if LIBCURL_VERSION_NUM >= 0x074400
+        curl_multi_wakeup(_curl_multi);
+#endif
+    }
+
+    void sk_wait_for_request(sk_pending_request *request)
+    {
+        unique_lock<mutex> lock(request->lock);
+        request->finished.wait(lock, [&] { return request->complete; });
+    }
+
+    void sk_release_pending_request(sk_pending_request *request)
+    {
+        bool delete_now;
+
+        {
+            lock_guard<mutex> lock(request->lock);
+            request->id = NONE_PTR;
+            request->released = true;
+            delete_now = request->complete and not request->callback_pending;
+        }
+
+        if ( delete_now ) _delete_pending_request(request);
+    }
+
+    void sk_dispatch_http_callbacks()
+    {
+        sk_pending_request *request;
+
+        while (_completed_callback_queue.try_take(request))
+        {
+            bool released;
+            {
+                lock_guard<mutex> lock(request->lock);
+                released = request->released;
+            }
+
+            if ( not released ) request->on_complete(request);
+
+            bool delete_now;
+            {
+                lock_guard<mutex> lock(request->lock);
+                request->callback_pending = false;
+                delete_now = request->released;
+            }
+
+            if ( delete_now ) _delete_pending_request(request);
+        }
+    }
 }
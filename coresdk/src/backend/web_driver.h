@@ -10,6 +10,8 @@
 #define __sgsdl2__SGSDL2Web__
 
 #include "backend_types.h"
+
+#include <cstdio>
 namespace splashkit_lib
 {
     void sk_init_web();
@@ -17,8 +19,39 @@ namespace splashkit_lib
 
     sk_http_response *sk_http_post(const string &host, unsigned short port, const string &body);
     sk_http_response *sk_http_get(const string &host, unsigned short port);
+
+    /**
+     * Get requests that pass the body on as it arrives, instead of buffering
+     * it in the response. The response's message is left empty.
+     */
+    sk_http_response *sk_http_get_to_file(const string &host, unsigned short port, FILE *file);
+    sk_http_response *sk_http_get_streamed(const string &host, unsigned short port, http_data_callback *on_data);
     sk_http_response *sk_http_put(const string &host, unsigned short port, const string &body);
     sk_http_response *sk_http_delete(const string &host, unsigned short port, const string &body);
     sk_http_response *sk_http_make_request(const sk_http_request &request);
+
+    /**
+     * When enabled, get requests are served from, and saved to, an on disk
+     * cache in the directory. Entries are reused while fresh according to
+     * their Cache-Control max-age, and revalidated with the server using
+     * their ETag and Last-Modified values once stale.
+     */
+    void sk_enable_http_cache(const string &directory, unsigned long max_bytes);
+    void sk_disable_http_cache();
+    void sk_clear_http_cache();
+
+    /**
+     * Queues the request to be made on the background request thread, which
+     * is started on first use and runs all transfers through a curl multi handle.
+     */
+    void sk_http_make_request_async(sk_pending_request *request);
+    void sk_wait_for_request(sk_pending_request *request);
+    void sk_release_pending_request(sk_pending_request *request);
+
+    /**
+     * Calls the on_complete callbacks of requests that have finished. Called
+     * from process_events so callbacks run on the user's thread.
+     */
+    void sk_dispatch_http_callbacks();
 }
 #endif /* defined(__sgsdl2__SGSDL2Web__) */
@@ -13,8 +13,14 @@
 
 #include <iostream>
 #include <cstring>
+#include <list>
+#include <functional>
+#include <atomic>
+
+#include <zlib.h>
 
 using std::to_string;
+using std::list;
 
 namespace splashkit_lib
 {
@@ -25,6 +31,280 @@ namespace splashkit_lib
         unsigned short port;
     };
 
+    // Responses smaller than this are sent uncompressed, as gzip framing would cancel out any saving
+    static const unsigned long COMPRESSION_THRESHOLD = 1024;
+
+    // Number of recently compressed bodies kept, and the largest body that will be cached
+    static const size_t COMPRESSION_CACHE_ENTRIES = 16;
+    static const unsigned long COMPRESSION_CACHE_MAX_BODY = 1024 * 1024;
+
+    enum _content_encoding
+    {
+        IDENTITY_ENCODING,
+        GZIP_ENCODING,
+        DEFLATE_ENCODING
+    };
+
+    struct _compressed_body
+    {
+        _content_encoding   encoding;
+        size_t              hash;
+        string              body;
+        string              compressed;
+    };
+
+    // Most recently used entries are kept at the front
+    static list<_compressed_body> compression_cache;
+    static mutex compression_cache_mutex;
+    static std::atomic<unsigned long> compression_cache_hits(0);
+
+    static bool _is_compressible_type(const string &content_type)
+    {
+        string type = content_type.substr(0, content_type.find(';'));
+        std::transform(type.begin(), type.end(), type.begin(), ::tolower);
+
+        return  type.compare(0, 5, "text/") == 0 or
+                type == "application/json" or
+                type == "application/javascript" or
+                type == "application/xml" or
+                type == "image/svg+xml" or
+                (type.length() > 5 and type.compare(type.length() - 5, 5, "+json") == 0) or
+                (type.length() > 4 and type.compare(type.length() - 4, 4, "+xml") == 0);
+    }
+
+    /*
+     * Picks the encoding to use from the client's Accept-Encoding header,
+     * preferring gzip. Codings listed with a zero quality are refused.
+     */
+    static _content_encoding _accepted_encoding(const char *accept_encoding)
+    {
+        if ( not accept_encoding ) return IDENTITY_ENCODING;
+
+        // Explicit entries win over the wildcard, so "*, gzip;q=0" must not select gzip
+        bool gzip = false, deflate = false, any = false;
+        bool gzip_listed = false, deflate_listed = false;
+        string tokens = accept_encoding;
+        std::transform(tokens.begin(), tokens.end(), tokens.begin(), ::tolower);
+
+        size_t at = 0;
+        while (at < tokens.length())
+        {
+            size_t end = tokens.find(',', at);
+            if ( end == string::npos ) end = tokens.length();
+
+            string token = tokens.substr(at, end - at);
+            at = end + 1;
+
+            size_t params = token.find(';');
+            string coding = trim(token.substr(0, params));
+            bool refused = false;
+
+            if ( params != string::npos )
+            {
+                size_t q = token.find("q=", params);
+                refused = q != string::npos and atof(token.c_str() + q + 2) <= 0.0;
+            }
+
+            if ( coding == "gzip" or coding == "x-gzip" )
+            {
+                gzip_listed = true;
+                gzip = gzip or not refused;
+            }
+            else if ( coding == "deflate" )
+            {
+                deflate_listed = true;
+                deflate = deflate or not refused;
+            }
+            else if ( coding == "*" )
+            {
+                any = not refused;
+            }
+        }
+
+        if ( gzip or (any and not gzip_listed) ) return GZIP_ENCODING;
+        if ( deflate or (any and not deflate_listed) ) return DEFLATE_ENCODING;
+        return IDENTITY_ENCODING;
+    }
+
+    static bool _compress(const char *data, unsigned long size, _content_encoding encoding, string &out)
+    {
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+
+        // 15 bits of window, +16 asks zlib for a gzip rather than a zlib wrapper
+        int window_bits = encoding == GZIP_ENCODING ? 15 + 16 : 15;
+        if ( deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY) != Z_OK )
+        {
+            LOG(WARNING) << "Unable to initialise zlib to compress web response";
+            return false;
+        }
+
+        out.resize(deflateBound(&stream, size));
+
+        stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+        stream.avail_in = static_cast<uInt>(size);
+        stream.next_out = reinterpret_cast<Bytef *>(&out[0]);
+        stream.avail_out = static_cast<uInt>(out.size());
+
+        int result = deflate(&stream, Z_FINISH);
+        out.resize(stream.total_out);
+        deflateEnd(&stream);
+
+        return result == Z_STREAM_END;
+    }
+
+    /*
+     * Returns the compressed form of the body, reusing the result from a
+     * previous response when the same body was recently sent.
+     */
+    static bool _compressed_body_for(const char *data, unsigned long size, _content_encoding encoding, string &out)
+    {
+        bool cacheable = size <= COMPRESSION_CACHE_MAX_BODY;
+        size_t hash = 0;
+
+        if ( cacheable )
+        {
+            hash = std::hash<std::string_view>()(std::string_view(data, size));
+
+            lock_guard<mutex> lock(compression_cache_mutex);
+            for (auto it = compression_cache.begin(); it != compression_cache.end(); ++it)
+            {
+                if ( it->hash == hash and it->encoding == encoding and it->body.compare(0, string::npos, data, size) == 0 )
+                {
+                    compression_cache.splice(compression_cache.begin(), compression_cache, it);
+                    out = it->compressed;
+                    compression_cache_hits++;
+                    return true;
+                }
+            }
+        }
+
+        if ( not _compress(data, size, encoding, out) ) return false;
+
+        if ( cacheable )
+        {
+            lock_guard<mutex> lock(compression_cache_mutex);
+            compression_cache.push_front({encoding, hash, string(data, size), out});
+            if ( compression_cache.size() > COMPRESSION_CACHE_ENTRIES )
+                compression_cache.pop_back();
+        }
+
+        return true;
+    }
+
+    static bool _has_header(const vector<string> &headers, const string &name)
+    {
+        for (const string &header : headers)
+        {
+            if ( header.length() > name.length() and header[name.length()] == ':' and
+                 strncasecmp(header.c_str(), name.c_str(), name.length()) == 0 )
+                return true;
+        }
+        return false;
+    }
+
+    string sk_encode_response_body(const sk_http_response *response, const char *accept_encoding, const char *&body, unsigned long &body_size, string &compressed)
+    {
+        body = response->message;
+        body_size = response->message_size;
+
+        // Compress larger text based responses for clients that accept it,
+        // unless the user has already set their own encoding
+        if ( not _is_compressible_type(response->content_type) or _has_header(response->headers, "Content-Encoding") ) return "";
+
+        string encoding_headers = "Vary: Accept-Encoding\r\n";
+
+        _content_encoding encoding = _accepted_encoding(accept_encoding);
+
+        if ( encoding != IDENTITY_ENCODING and body_size >= COMPRESSION_THRESHOLD and
+             _compressed_body_for(body, body_size, encoding, compressed) and compressed.size() < body_size )
+        {
+            body = compressed.data();
+            body_size = compressed.size();
+            encoding_headers += encoding == GZIP_ENCODING ? "Content-Encoding: gzip\r\n" : "Content-Encoding: deflate\r\n";
+        }
+
+        return encoding_headers;
+    }
+
+    unsigned long sk_compression_cache_hits()
+    {
+        return compression_cache_hits;
+    }
+
+    static int _hex_value(char c)
+    {
+        if (c >= '0' and c <= '9') return c - '0';
+        if (c >= 'A' and c <= 'F') return c - 'A' + 10;
+        if (c >= 'a' and c <= 'f') return c - 'a' + 10;
+        return -1;
+    }
+
+    /*
+     * Decodes a url encoded query string component. Characters are
+     * appended into `out`, which is reserved up front as the decoded
+     * text is never longer than the encoded text.
+     */
+    static void _url_decode(const char *start, const char *end, string &out)
+    {
+        out.clear();
+        out.reserve(end - start);
+
+        for (const char *c = start; c < end; c++)
+        {
+            if ( *c == '%' and end - c > 2 and _hex_value(c[1]) >= 0 and _hex_value(c[2]) >= 0 )
+            {
+                out.push_back((char)((_hex_value(c[1]) << 4) + _hex_value(c[2])));
+                c += 2;
+            }
+            else if ( *c == '+' )
+            {
+                out.push_back(' ');
+            }
+            else
+            {
+                out.push_back(*c);
+            }
+        }
+    }
+
+    void sk_parse_query_string(const string &query_string, vector<std::pair<string, string>> &out)
+    {
+        const char *at = query_string.c_str();
+        const char *end = at + query_string.length();
+
+        while (at < end)
+        {
+            const char *param_end = static_cast<const char *>(memchr(at, '&', end - at));
+            if ( not param_end ) param_end = end;
+
+            if ( param_end > at )
+            {
+                const char *eq = static_cast<const char *>(memchr(at, '=', param_end - at));
+                if ( not eq ) eq = param_end;
+
+                out.emplace_back();
+                _url_decode(at, eq, out.back().first);
+                _url_decode(eq < param_end ? eq + 1 : param_end, param_end, out.back().second);
+            }
+
+            at = param_end + 1;
+        }
+    }
+
+    static bool _is_websocket_request(sk_web_server *server, struct mg_connection *conn, const char *uri)
+    {
+        const char *upgrade = mg_get_header(conn, "Upgrade");
+        if ( not upgrade or strcasecmp(upgrade, "websocket") != 0 or not uri ) return false;
+
+        lock_guard<mutex> lock(server->websocket_lock);
+        for (sk_websocket_endpoint *endpoint : server->websocket_endpoints)
+        {
+            if ( endpoint->path == uri ) return true;
+        }
+        return false;
+    }
+
     static int begin_request_handler(struct mg_connection *conn)
     {
         _web_server_ctx_data *user_data;
@@ -44,12 +324,21 @@ namespace splashkit_lib
 
         const struct mg_request_info *request_info = mg_get_request_info(conn);
 
+        // Returning zero lets civetweb pass the upgrade on to the websocket handlers
+        if ( _is_websocket_request(servers[port], conn, request_info->request_uri) )
+        {
+            return 0;
+        }
+
         sk_http_request *r = new sk_http_request;
         r->id = HTTP_REQUEST_PTR;
         r->uri = request_info->request_uri ? request_info->request_uri : "" ;
         r->query_string = request_info->query_string ? request_info->query_string : "";
         r->filename = "";
 
+        // Decode the parameters here, on the civetweb thread, so the user's lookups are cheap
+        sk_parse_query_string(r->query_string, r->query_parameters);
+
         // Populate headers
         for (auto header : request_info->http_headers) {
           if (header.name != nullptr) {
@@ -100,9 +389,16 @@ namespace splashkit_lib
         servers[port]->request_queue.put(r); // Add request to concurrent queue
         r->control.acquire(); // Waits until user returns response.
 
+        sk_http_response *response = r->response;
+
+        const char *body;
+        unsigned long body_size;
+        string compressed;
+        string encoding_headers = sk_encode_response_body(response, mg_get_header(conn, "Accept-Encoding"), body, body_size, compressed);
+
         // Concatenate headers vector
         string headers;
-        for (string &header : r->response->headers) {
+        for (string &header : response->headers) {
           headers.append(header.append("\r\n"));
         }
 
@@ -113,13 +409,16 @@ namespace splashkit_lib
                   "Connection: close\r\n"
                   "Content-Length: %lu\r\n" // Always set Content-Length
                   "%s"
-                  "\r\n"
-                  "%s",
-                  r->response->code,
-                  r->response->content_type.c_str(),
-                  r->response->message_size,
-                  headers.c_str(),
-                  r->response->message);
+                  "%s"
+                  "\r\n",
+                  response->code,
+                  response->content_type.c_str(),
+                  body_size,
+                  encoding_headers.c_str(),
+                  headers.c_str());
+
+        // Write the body separately, as compressed data may contain null bytes
+        mg_write(conn, body, body_size);
 
         // Indicate that the request has been dealt with - so it is no longer a request ptr
         r->id = NONE_PTR;
@@ -134,6 +433,248 @@ namespace splashkit_lib
         return 1;
     }
 
+    static int websocket_connect_handler(const struct mg_connection *conn, void *cbdata)
+    {
+        // Zero accepts the connection
+        return 0;
+    }
+
+    static void websocket_ready_handler(struct mg_connection *conn, void *cbdata)
+    {
+        sk_websocket_endpoint *endpoint = static_cast<sk_websocket_endpoint *>(cbdata);
+
+        sk_websocket_data *ws = new sk_websocket_data;
+        ws->id = WEBSOCKET_PTR;
+        ws->endpoint = endpoint;
+        ws->conn = conn;
+        ws->open = true;
+        ws->released = false;
+
+        mg_set_user_connection_data(conn, ws);
+
+        {
+            lock_guard<mutex> lock(endpoint->server->websocket_lock);
+            endpoint->server->websockets.push_back(ws);
+        }
+
+        endpoint->server->new_websocket_queue.put(ws);
+    }
+
+    static int websocket_data_handler(struct mg_connection *conn, int flags, char *data, size_t data_len, void *cbdata)
+    {
+        sk_websocket_data *ws = static_cast<sk_websocket_data *>(mg_get_user_connection_data(conn));
+        if ( not ws ) return 0;
+
+        int opcode = flags & 0x0f;
+        bool final_frame = flags & 0x80;
+
+        switch (opcode)
+        {
+            case MG_WEBSOCKET_OPCODE_CONNECTION_CLOSE:
+                return 0; // returning zero closes the connection
+
+            case MG_WEBSOCKET_OPCODE_TEXT:
+            case MG_WEBSOCKET_OPCODE_BINARY:
+            case MG_WEBSOCKET_OPCODE_CONTINUATION:
+                break;
+
+            default:
+                return 1; // ping and pong frames are handled by civetweb
+        }
+
+        ws->part_msg_data.insert(ws->part_msg_data.end(), data, data + data_len);
+
+        if ( not final_frame ) return 1;
+
+        bool released;
+        {
+            lock_guard<mutex> lock(ws->lock);
+            released = ws->released;
+        }
+
+        if ( not released )
+        {
+            sk_message *m = new sk_message;
+            m->id = MESSAGE_PTR;
+            m->data.swap(ws->part_msg_data);
+            m->protocol = TCP;
+            m->connection = nullptr;
+            m->websocket = ws;
+
+            const struct mg_request_info *request_info = mg_get_request_info(conn);
+            m->host = request_info->remote_addr;
+            m->port = request_info->remote_port;
+
+            // Queued without the lock - if the user releases ws meanwhile, collecting detaches the message
+            ws->endpoint->server->websocket_message_queue.put(m);
+        }
+
+        ws->part_msg_data.clear();
+        return 1;
+    }
+
+    static void websocket_close_handler(const struct mg_connection *conn, void *cbdata)
+    {
+        sk_websocket_data *ws = static_cast<sk_websocket_data *>(mg_get_user_connection_data(conn));
+        if ( not ws ) return;
+
+        sk_web_server *server = ws->endpoint->server;
+
+        // Same lock order as sk_close_websocket: server first, then ws
+        lock_guard<mutex> server_lock(server->websocket_lock);
+        lock_guard<mutex> lock(ws->lock);
+        ws->conn = nullptr;
+        ws->open = false;
+
+        if ( ws->released )
+        {
+            // Its messages may still be queued, so ws is deleted once they are collected
+            server->finished_websockets.push_back(ws);
+        }
+        else if ( erase_from_vector(server->websockets, ws) )
+        {
+            // The user still holds ws, but it should no longer receive broadcasts
+            server->closed_websockets.push_back(ws);
+        }
+    }
+
+    void sk_add_websocket_endpoint(sk_web_server *server, const string &path)
+    {
+        sk_websocket_endpoint *endpoint = new sk_websocket_endpoint;
+        endpoint->server = server;
+        endpoint->path = path;
+
+        {
+            lock_guard<mutex> lock(server->websocket_lock);
+            server->websocket_endpoints.push_back(endpoint);
+        }
+
+        mg_set_websocket_handler(server->ctx,
+                                 path.c_str(),
+                                 &websocket_connect_handler,
+                                 &websocket_ready_handler,
+                                 &websocket_data_handler,
+                                 &websocket_close_handler,
+                                 endpoint);
+    }
+
+    void sk_collect_websocket_events(sk_web_server *server)
+    {
+        // Taken before the messages, as a finished websocket's messages are all queued by now
+        vector<sk_websocket_data*> finished;
+        {
+            lock_guard<mutex> lock(server->websocket_lock);
+            finished.swap(server->finished_websockets);
+        }
+
+        sk_websocket_data *ws;
+        while (server->new_websocket_queue.try_take(ws))
+        {
+            server->new_websockets.push_back(ws);
+        }
+
+        sk_message *m;
+        while (server->websocket_message_queue.try_take(m))
+        {
+            // Messages that arrived as the user released their websocket no longer refer to it
+            lock_guard<mutex> lock(m->websocket->lock);
+            if ( m->websocket->released ) m->websocket = nullptr;
+
+            server->websocket_messages.push_back(m);
+        }
+
+        for (sk_websocket_data *done : finished)
+        {
+            done->id = NONE_PTR;
+            delete done;
+        }
+    }
+
+    bool sk_websocket_send(sk_websocket_data *ws, const string &data)
+    {
+        lock_guard<mutex> lock(ws->lock);
+        if ( not ws->conn ) return false;
+
+        return mg_websocket_write(ws->conn, MG_WEBSOCKET_OPCODE_TEXT, data.c_str(), data.length()) > 0;
+    }
+
+    void sk_websocket_broadcast(sk_web_server *server, const string &path, const string &data)
+    {
+        // Copy the websockets, so a slow client only holds up its own lock while writing
+        vector<sk_websocket_data*> targets;
+        {
+            lock_guard<mutex> lock(server->websocket_lock);
+            for (sk_websocket_data *ws : server->websockets)
+            {
+                if ( path.empty() or ws->endpoint->path == path ) targets.push_back(ws);
+            }
+        }
+
+        // Only the user's thread deletes websockets, so these stay valid while writing
+        for (sk_websocket_data *ws : targets)
+        {
+            sk_websocket_send(ws, data);
+        }
+    }
+
+    void sk_close_websocket(sk_websocket_data *ws)
+    {
+        sk_web_server *server = ws->endpoint->server;
+        bool still_connected;
+
+        {
+            lock_guard<mutex> server_lock(server->websocket_lock);
+            lock_guard<mutex> lock(ws->lock);
+
+            // Civetweb still owns the connection - its close handler will pass ws on to be deleted
+            still_connected = ws->conn != nullptr;
+            ws->released = true;
+
+            erase_from_vector(server->websockets, ws);
+            erase_from_vector(server->closed_websockets, ws);
+        }
+
+        if ( still_connected )
+        {
+            // Written with only this websocket locked, so other clients are not held up
+            lock_guard<mutex> lock(ws->lock);
+            if ( ws->conn ) mg_websocket_write(ws->conn, MG_WEBSOCKET_OPCODE_CONNECTION_CLOSE, "", 0);
+        }
+
+        erase_from_vector(server->new_websockets, ws);
+
+        // No more messages can arrive for ws, so detach those waiting to be read and those already read
+        sk_collect_websocket_events(server);
+        for (sk_message *m : server->websocket_messages)
+        {
+            if ( m->websocket == ws ) m->websocket = nullptr;
+        }
+
+        auto &read = server->read_websocket_messages;
+        read.erase(std::remove_if(read.begin(), read.end(), [ws](sk_message *m)
+                   {
+                       if ( m->websocket != ws ) return false;
+                       m->websocket = nullptr;
+                       return true;
+                   }), read.end());
+
+        if ( not still_connected )
+        {
+            ws->id = NONE_PTR;
+            delete ws;
+        }
+    }
+
+    void sk_websocket_message_read(sk_message *m)
+    {
+        if ( m->websocket ) m->websocket->endpoint->server->read_websocket_messages.push_back(m);
+    }
+
+    void sk_release_websocket_message(sk_message *m)
+    {
+        if ( m->websocket ) erase_from_vector(m->websocket->endpoint->server->read_websocket_messages, m);
+    }
+
     void sk_flush_request(sk_http_request *request)
     {
         send_response(request, HTTP_STATUS_SERVICE_UNAVAILABLE, "Server closed");
@@ -248,6 +789,43 @@ namespace splashkit_lib
 
         mg_stop(server->ctx);
 
+        // Civetweb has now closed every websocket, so they can be released
+        sk_collect_websocket_events(server);
+
+        for (sk_message *m : server->websocket_messages)
+        {
+            m->id = NONE_PTR;
+            delete m;
+        }
+        server->websocket_messages.clear();
+
+        // Messages the user is still holding must not refer to the websockets freed below
+        for (sk_message *m : server->read_websocket_messages)
+        {
+            m->websocket = nullptr;
+        }
+        server->read_websocket_messages.clear();
+
+        for (sk_websocket_data *ws : server->websockets)
+        {
+            ws->id = NONE_PTR;
+            delete ws;
+        }
+        for (sk_websocket_data *ws : server->closed_websockets)
+        {
+            ws->id = NONE_PTR;
+            delete ws;
+        }
+        server->websockets.clear();
+        server->closed_websockets.clear();
+        server->new_websockets.clear();
+
+        for (sk_websocket_endpoint *endpoint : server->websocket_endpoints)
+        {
+            delete endpoint;
+        }
+        server->websocket_endpoints.clear();
+
         auto it = servers.find(server->port);
         if (it != servers.end())
         {
@@ -16,12 +16,60 @@ namespace splashkit_lib
 {
     void sk_flush_request(sk_http_request *request);
 
+    /**
+     * Splits a raw query string into its decoded name/value pairs. Pairs are
+     * appended to `out` in the order they appear in the query string.
+     */
+    void sk_parse_query_string(const string &query_string, vector<std::pair<string, string>> &out);
+
     sk_http_request* sk_get_request(sk_web_server *server);
 
+    /**
+     * Picks the body to send for the response, compressing it with the best
+     * encoding in the client's Accept-Encoding header when it is text based
+     * and at least 1KB. Compressed bodies are kept in `compressed`. Returns
+     * the headers that describe the encoding.
+     */
+    string sk_encode_response_body(const sk_http_response *response, const char *accept_encoding, const char *&body, unsigned long &body_size, string &compressed);
+
+    /**
+     * Returns the number of responses that reused a recently compressed body.
+     */
+    unsigned long sk_compression_cache_hits();
+
     bool sk_has_waiting_requests(sk_web_server *server);
 
     sk_web_server* sk_start_web_server(unsigned short port);
 
     void sk_stop_web_server(sk_web_server *server);
+
+    void sk_add_websocket_endpoint(sk_web_server *server, const string &path);
+
+    /**
+     * Moves new websockets and messages handed over by civetweb threads
+     * into the server's vectors, so they can be used from the user's thread.
+     */
+    void sk_collect_websocket_events(sk_web_server *server);
+
+    bool sk_websocket_send(sk_websocket_data *ws, const string &data);
+
+    /**
+     * Sends the data to the server's open websockets on the path, or to all
+     * of them when the path is empty.
+     */
+    void sk_websocket_broadcast(sk_web_server *server, const string &path, const string &data);
+
+    void sk_close_websocket(sk_websocket_data *ws);
+
+    /**
+     * Records that the user has read a websocket message, so it can be
+     * detached from its websocket when that is closed or the server stops.
+     */
+    void sk_websocket_message_read(sk_message *m);
+
+    /**
+     * Stops tracking a websocket message that is about to be freed.
+     */
+    void sk_release_websocket_message(sk_message *m);
 }
 #endif /* defined(__sgsdl2__SGSDL2WebServer__) */
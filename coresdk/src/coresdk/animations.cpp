@@ -18,18 +18,21 @@
 #include <cctype>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <vector>
 #include <map>
+#include <unordered_map>
 
 using std::string;
 using std::vector;
 using std::map;
+using std::unordered_map;
 using std::ifstream;
 using std::to_string;
 
 namespace splashkit_lib
 {
-    static map<string, animation_script> _animation_scripts;
+    static unordered_map<string, animation_script> _animation_scripts;
 
     struct row_data
     {
@@ -46,7 +49,11 @@ namespace splashkit_lib
 
     int animation_index(animation_script temp, const string &name);
 
-    animation_script load_animation_script(const string &name, const string &filename)
+    /**
+     * Reads an animation script from the input. The filename is kept with
+     * the script and used in error messages.
+     */
+    static animation_script _load_animation_script(const string &name, const string &filename, std::istream &input)
     {
         animation_script result;
         vector<row_data> rows;
@@ -55,16 +62,6 @@ namespace splashkit_lib
         string line, line_id, data;
         int line_no, max_id;
 
-        string path = path_to_resource(filename, ANIMATION_RESOURCE);
-
-        if ( ! file_exists(path) )
-        {
-            LOG(WARNING) << cat({ "Unable to locate animation file for ", name, " (", path, ")"});
-            return nullptr;
-        }
-
-        ifstream input(path);
-
         //
         // Declare lambdas that access above data
         //
@@ -313,7 +310,7 @@ namespace splashkit_lib
         auto build_frame_lists = [&]()
         {
             // We have the data ready, now lets create the linked lists...
-            result = new(_animation_script_data);
+            result = new_resource<_animation_script_data>();
 
             result->id          = ANIMATION_SCRIPT_PTR;
             result->name        = name;        // name taken from parameter of DoLoadAnimationScript
@@ -443,7 +440,7 @@ namespace splashkit_lib
 
         if (not verify_version())
         {
-            LOG(WARNING) << "Error loading animation script: " + path;
+            LOG(WARNING) << "Error loading animation script: " + filename;
             return nullptr;
         }
 
@@ -467,6 +464,26 @@ namespace splashkit_lib
         return result;
     }
 
+    animation_script load_animation_script(const string &name, const string &filename)
+    {
+        string path = resource_file_path(filename, ANIMATION_RESOURCE);
+
+        if ( path.empty() )
+        {
+            LOG(WARNING) << cat({ "Unable to locate animation file for ", name, " (", path_to_resource(filename, ANIMATION_RESOURCE), ")"});
+            return nullptr;
+        }
+
+        ifstream input(path);
+        return _load_animation_script(name, filename, input);
+    }
+
+    animation_script load_animation_script_from_memory(const string &name, const char *data, unsigned long size)
+    {
+        std::istringstream input(string(data, size));
+        return _load_animation_script(name, name, input);
+    }
+
     animation_script animation_script_named(const string &name)
     {
         if (has_animation_script(name))
@@ -495,7 +512,7 @@ namespace splashkit_lib
         _animation_scripts.erase(script_to_free->name);
 
         script_to_free->id = NONE_PTR;
-        delete(script_to_free);
+        delete_resource(script_to_free);
     }
 
     void free_animation_script(const string &name)
@@ -548,7 +565,7 @@ namespace splashkit_lib
             _remove_animation(ani->script, ani);
             ani->id = NONE_PTR;
 
-            delete(ani); //ani may have been overridden by last call...
+            delete_resource(ani); //ani may have been overridden by last call...
         }
     }
 
@@ -794,7 +811,7 @@ namespace splashkit_lib
             return result;
         }
 
-        result = new(_animation_data);
+        result = new_resource<_animation_data>();
 
         result->id = ANIMATION_PTR;
         result->current_frame = nullptr;
@@ -15,11 +15,22 @@
 #include "timers.h"
 #include "text.h"
 #include "audio.h"
+#include "graphics_driver.h"
+#include "audio_driver.h"
+#include "concurrency_utils.h"
+#include "core_driver.h"
+#include "pack_driver.h"
 
 #include <map>
 #include <vector>
 #include <iostream>
 #include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <set>
+#include <sstream>
 
 using std::ifstream;
 using std::to_string;
@@ -41,6 +52,10 @@ namespace splashkit_lib
 
     static map<string, resource_bundle> _resource_bundles;
 
+    // Bundles being loaded in the background, by name
+    struct _bundle_load;
+    static map<string, _bundle_load *> _bundle_loads;
+
 
     bool has_resource_bundle(const string &name)
     {
@@ -62,7 +77,244 @@ namespace splashkit_lib
         else return OTHER_RESOURCE;
     }
 
-    void load_resource_bundle(const string &name, const string &filename)
+    // The details from one line of a bundle file
+    struct _bundle_line
+    {
+        resource_kind kind;
+        string name;
+        string path;
+        string text;
+        int line_no;
+    };
+
+    /**
+     * Reads the details of a resource from a line of the bundle file,
+     * returning false if the line is not valid.
+     */
+    static bool _read_bundle_line(const string &bundle_name, const string &line, int line_no, _bundle_line &result)
+    {
+        result.kind = string_to_resource_kind(extract_delimited(1, line, ','));
+        result.name = trim(extract_delimited(2, line, ','));
+        result.path = trim(extract_delimited(3, line, ','));
+        result.text = line;
+        result.line_no = line_no;
+
+        if ( result.kind == OTHER_RESOURCE )
+        {
+            LOG(WARNING) << "Unknown resource type at line " + to_string(line_no) + " of bundle " + bundle_name;
+            return false;
+        }
+
+        if ( result.name.length() == 0 )
+        {
+            LOG(WARNING) << "Name missing for resource at line " + to_string(line_no) + " of bundle " + bundle_name;
+            return false;
+        }
+
+        if ( result.path.length() == 0 && result.kind != TIMER_RESOURCE )
+        {
+            LOG(WARNING) << "Name missing for resource at line " + to_string(line_no) + " of bundle " + bundle_name;
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Reads each resource line of the bundle file, skipping blank lines and
+     * comments.
+     */
+    static void _read_bundle_lines(const string &bundle_name, std::istream &input, vector<_bundle_line> &result)
+    {
+        int line_no = 0;
+        string line;
+
+        while (getline(input, line))
+        {
+            line_no = line_no + 1;
+
+            line = trim(line);
+            if (line.length() == 0) continue;  //skip empty lines
+            if (line.substr(0,2) == "//") continue; //skip lines starting with //
+
+            _bundle_line details;
+            if ( _read_bundle_line(bundle_name, line, line_no, details) )
+                result.push_back(details);
+        }
+    }
+
+    // Name of the entry holding the bundle file a pack was made from
+    static const string PACK_ROOT_BUNDLE = "bundle";
+
+    /**
+     * Returns the name of the pack entry for a resource file, matching the
+     * folder the file would be found in within `Resources`.
+     */
+    static string _pack_entry_name(resource_kind kind, const string &path)
+    {
+        switch ( kind )
+        {
+            case IMAGE_RESOURCE:        return "images/" + path;
+            case SOUND_RESOURCE:        return "sounds/" + path;
+            case MUSIC_RESOURCE:        return "sounds/" + path;
+            case FONT_RESOURCE:         return "fonts/" + path;
+            case ANIMATION_RESOURCE:    return "animations/" + path;
+            case BUNDLE_RESOURCE:       return "bundles/" + path;
+            default:                    return path;
+        }
+    }
+
+    /**
+     * Reads the lines of a bundle file stored in the pack, returning false
+     * if the pack does not contain it.
+     */
+    static bool _read_packed_bundle(const string &bundle_name, const string &entry_name, const sk_pack *pack, vector<_bundle_line> &result)
+    {
+        const char *data;
+        size_t size;
+        vector<char> buffer;
+
+        if ( ! sk_read_pack_entry(pack, entry_name, data, size, buffer) )
+        {
+            LOG(WARNING) << cat({ "Unable to read bundle ", bundle_name, " from resource pack ", pack->path });
+            return false;
+        }
+
+        std::istringstream input(string(data, size));
+        _read_bundle_lines(bundle_name, input, result);
+        return true;
+    }
+
+    // Applies the optional cell details from a bitmap's line in the bundle
+    static void _set_bundle_bitmap_cells(bitmap bmp, const _bundle_line &details, const string &bundle_name)
+    {
+        const string &line = details.text;
+
+        int num_delim = count_delimiter(line, ',');
+        if ( num_delim > 2 and num_delim != 7 )
+        {
+            LOG(WARNING) << "Incorrect cell options for bitmap " + details.name + " at " + to_string(details.line_no) + " of bundle " + bundle_name;
+            return;
+        }
+        else if ( num_delim == 2 ) return;
+
+        bitmap_set_cell_details(bmp,
+                                str_to_int(extract_delimited(4, line, ',')),
+                                str_to_int(extract_delimited(5, line, ',')),
+                                str_to_int(extract_delimited(6, line, ',')),
+                                str_to_int(extract_delimited(7, line, ',')),
+                                str_to_int(extract_delimited(8, line, ',')));
+    }
+
+    static void _load_packed_bundle(const string &name, const string &entry_name, const sk_pack *pack);
+
+    /**
+     * Loads the resource from its data in the pack, returning false if the
+     * pack does not contain the resource's file.
+     */
+    static bool _load_packed_resource(const _bundle_line &details, const string &bundle_name, const sk_pack *pack, bool &loaded)
+    {
+        const char *data;
+        size_t size;
+        vector<char> buffer;
+
+        if ( ! sk_read_pack_entry(pack, _pack_entry_name(details.kind, details.path), data, size, buffer) ) return false;
+
+        switch ( details.kind )
+        {
+            case IMAGE_RESOURCE:
+            {
+                bitmap bmp = load_bitmap_from_memory(details.name, data, size);
+                loaded = bmp != nullptr;
+                if ( loaded ) _set_bundle_bitmap_cells(bmp, details, bundle_name);
+                break;
+            }
+            case FONT_RESOURCE:
+                loaded = load_font_from_memory(details.name, data, size) != nullptr;
+                break;
+            case SOUND_RESOURCE:
+                loaded = load_sound_effect_from_memory(details.name, data, size) != nullptr;
+                break;
+            case MUSIC_RESOURCE:
+                loaded = load_music_from_memory(details.name, data, size) != nullptr;
+                break;
+            case ANIMATION_RESOURCE:
+                loaded = load_animation_script_from_memory(details.name, data, size) != nullptr;
+                break;
+            default:
+                return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Loads the resource described by the bundle line, returning true if it
+     * was loaded. Resources with files in the pack are loaded from the pack,
+     * others from their files in `Resources`.
+     */
+    static bool _load_bundle_resource(const _bundle_line &details, const string &bundle_name, const sk_pack *pack)
+    {
+        bool loaded = false;
+        if ( pack and details.kind != BUNDLE_RESOURCE and _load_packed_resource(details, bundle_name, pack, loaded) )
+            return loaded;
+
+        switch ( details.kind )
+        {
+            case BUNDLE_RESOURCE:
+                if ( pack and sk_pack_has_entry(pack, _pack_entry_name(BUNDLE_RESOURCE, details.path)) )
+                    _load_packed_bundle(details.name, _pack_entry_name(BUNDLE_RESOURCE, details.path), pack);
+                else
+                    load_resource_bundle(details.name, details.path);
+                return has_resource_bundle(details.name);
+            case TIMER_RESOURCE:
+                create_timer(details.name);
+                return true;
+            case IMAGE_RESOURCE:
+            {
+                bitmap bmp = load_bitmap(details.name, details.path);
+                if ( ! bmp ) return false;
+                _set_bundle_bitmap_cells(bmp, details, bundle_name);
+                return true;
+            }
+            case FONT_RESOURCE:
+                load_font(details.name, details.path);
+                return has_font(details.name);
+            case SOUND_RESOURCE:
+                load_sound_effect(details.name, details.path);
+                return has_sound_effect(details.name);
+            case MUSIC_RESOURCE:
+                load_music(details.name, details.path);
+                return has_music(details.name);
+            case ANIMATION_RESOURCE:
+                load_animation_script(details.name, details.path);
+                return has_animation_script(details.name);
+            default:
+                return false;
+        }
+    }
+
+    // Loads each of the resources into a new bundle with the given name
+    static void _load_bundle_lines(const string &name, const vector<_bundle_line> &lines, const sk_pack *pack)
+    {
+        resource_bundle result;
+
+        for (const _bundle_line &details : lines)
+        {
+            if ( _load_bundle_resource(details, name, pack) )
+            {
+                bundled_resource br;
+                br.name = details.name;
+                br.kind = details.kind;
+
+                result.resources.push_back(br);
+            }
+        }
+
+        _resource_bundles[name] = result;
+    }
+
+    static void _load_packed_bundle(const string &name, const string &entry_name, const sk_pack *pack)
     {
         if ( has_resource_bundle(name) )
         {
@@ -70,126 +322,557 @@ namespace splashkit_lib
             return;
         }
 
-        string path = path_to_resource(filename, BUNDLE_RESOURCE);
+        vector<_bundle_line> lines;
+        if ( _read_packed_bundle(name, entry_name, pack, lines) )
+            _load_bundle_lines(name, lines, pack);
+    }
+
+    void load_resource_bundle(const string &name, const string &filename)
+    {
+        if ( has_resource_bundle(name) or _bundle_loads.count(name) > 0 )
+        {
+            LOG(WARNING) << "Attempting to load resource bundle twice.";
+            return;
+        }
+
+        string path = resource_file_path(filename, BUNDLE_RESOURCE);
 
-        if ( ! file_exists(path) )
+        if ( path.empty() )
         {
-            LOG(WARNING) << cat({ "Unable to locate bundle file for ", name, " (", path, ")"});
+            LOG(WARNING) << cat({ "Unable to locate bundle file for ", name, " (", path_to_resource(filename, BUNDLE_RESOURCE), ")"});
             return;
         }
 
-        int line_no = 0;
-        string line;
+        if ( sk_is_pack_file(path) )
+        {
+            sk_pack *pack = sk_open_pack(path);
+            if ( ! pack ) return;
+
+            _load_packed_bundle(name, PACK_ROOT_BUNDLE, pack);
+            sk_close_pack(pack);
+            return;
+        }
+
+        vector<_bundle_line> lines;
         ifstream input(path);
+        _read_bundle_lines(name, input, lines);
 
-        resource_bundle result;
+        _load_bundle_lines(name, lines, nullptr);
+    }
+
+    /**
+     * Finds the file for a resource, checking the path as given and then
+     * within `Resources`. Returns an empty string if it cannot be found.
+     */
+    static string _find_bundle_file(resource_kind kind, const string &path)
+    {
+        string file_path = find_resource_file(path, kind);
 
-        // Called on load of each bitmap
-        auto rb_load_bitmap = [&](string line_name, string line_path)
+        if ( file_path.empty() and kind == FONT_RESOURCE ) file_path = resource_file_path(path + ".ttf", kind);
+
+        return file_path;
+    }
+
+    // Adds the files for the bundle's resources to the lists of pack entries
+    static void _add_bundle_to_pack(const string &bundle_name, const vector<_bundle_line> &lines, vector<string> &entry_names, vector<string> &files, std::set<string> &added)
+    {
+        for (const _bundle_line &details : lines)
         {
-            bitmap bmp = load_bitmap(line_name, line_path);
-            int num_delim = count_delimiter(line, ',');
-            if ( num_delim > 2 and num_delim != 7 )
+            if ( details.kind == TIMER_RESOURCE ) continue;
+
+            string entry_name = _pack_entry_name(details.kind, details.path);
+            if ( added.count(entry_name) > 0 ) continue;
+
+            string file_path = details.kind == BUNDLE_RESOURCE ? resource_file_path(details.path, BUNDLE_RESOURCE) : _find_bundle_file(details.kind, details.path);
+            if ( file_path.empty() )
             {
-                LOG(WARNING) << "Incorrect cell options for bitmap " + line_name + " at " + to_string(line_no) + " of bundle " + name;
-                return;
+                LOG(WARNING) << cat({ "Unable to locate file for ", details.name, " (", details.path, ") in bundle ", bundle_name, ". It will be loaded from Resources instead." });
+                continue;
             }
-            else if ( num_delim == 2 ) return;
 
-            bitmap_set_cell_details(bmp,
-                                    str_to_int(extract_delimited(4, line, ',')),
-                                    str_to_int(extract_delimited(5, line, ',')),
-                                    str_to_int(extract_delimited(6, line, ',')),
-                                    str_to_int(extract_delimited(7, line, ',')),
-                                    str_to_int(extract_delimited(8, line, ',')));
-        };
+            added.insert(entry_name);
+            entry_names.push_back(entry_name);
+            files.push_back(file_path);
 
-        // Called for each line in the bundle text file
-        auto process_line = [&]()
+            if ( details.kind == BUNDLE_RESOURCE )
+            {
+                vector<_bundle_line> nested;
+                ifstream input(file_path);
+                _read_bundle_lines(details.name, input, nested);
+                _add_bundle_to_pack(details.name, nested, entry_names, files, added);
+            }
+        }
+    }
+
+    bool pack_resource_bundle(const string &filename, const string &pack_filename, bool compress)
+    {
+        string path = resource_file_path(filename, BUNDLE_RESOURCE);
+
+        if ( path.empty() )
         {
-            resource_kind kind = string_to_resource_kind(extract_delimited(1, line, ','));
-            string line_name = trim(extract_delimited(2, line, ','));
-            string line_path = trim(extract_delimited(3, line, ','));
+            LOG(WARNING) << cat({ "Unable to locate bundle file to pack (", path_to_resource(filename, BUNDLE_RESOURCE), ")"});
+            return false;
+        }
+
+        vector<_bundle_line> lines;
+        ifstream input(path);
+        _read_bundle_lines(filename, input, lines);
+
+        vector<string> entry_names = { PACK_ROOT_BUNDLE };
+        vector<string> files = { path };
+        std::set<string> added;
+
+        _add_bundle_to_pack(filename, lines, entry_names, files, added);
+
+        return sk_write_pack(pack_filename, entry_names, files, compress);
+    }
+
+    struct _bundle_load;
+
+    // A resource from a bundle that is being loaded in the background
+    struct _bundle_entry
+    {
+        _bundle_load    *load;
+        _bundle_line    details;
+
+        // Images and sound effects are decoded by a worker from the resolved file path,
+        // or from the named entry when the pack is set
+        bool            decode_on_worker;
+        const sk_pack   *pack;
+        string          file_path;
+        SDL_Surface     *image;
+        sk_sound_data   sound;
+    };
+
+    // A bundle that is being loaded in the background
+    struct _bundle_load
+    {
+        string                  name;
+        resource_bundle         result;
+        size_t                  total;
+        size_t                  done;
+
+        // Keeps the pack open until every bundle loading from it has finished
+        std::shared_ptr<sk_pack> pack;
+
+        // Nested bundles are loaded in the background too, and waited on here
+        vector<_bundle_entry *> nested;
+
+        // Set when the bundle is freed while loading - the remaining entries are
+        // discarded, and the resources already loaded are freed once it finishes
+        bool                    cancelled = false;
+    };
+
+    // Time to spend creating textures and registering resources on each call to process_events
+    static const double BUNDLE_UPLOAD_BUDGET_MS = 4;
+
+    static const unsigned int MIN_BUNDLE_WORKERS = 2;
+    static const unsigned int MAX_BUNDLE_WORKERS = 8;
+
+    // Entries handed to the workers at once - the rest wait in the pending jobs, where they can be cancelled
+    static const size_t MAX_BUNDLE_JOBS_IN_FLIGHT = 256;
 
 
-            if ( kind == OTHER_RESOURCE )
+    // Entries waiting for a worker, and entries loaded directly on the main thread
+    static std::deque<_bundle_entry *> _pending_jobs;
+    static std::deque<_bundle_entry *> _main_thread_entries;
+    static size_t _jobs_in_flight = 0;
+
+    // Entries decoded by the workers, ready to be finished on the main thread
+    static channel<_bundle_entry *> _ready_entries;
+
+    /**
+     * Threads that read and decode bundle resources. Declared after the ready
+     * channel, so the workers are stopped before the channel they put
+     * entries into is destroyed.
+     */
+    struct _bundle_worker_pool
+    {
+        channel<_bundle_entry *> jobs;
+        vector<thread> threads;
+
+        ~_bundle_worker_pool()
+        {
+            // A null entry tells a worker to stop
+            for (size_t i = 0; i < threads.size(); i++)
             {
-                LOG(WARNING) << "Unknown resource type at line " + to_string(line_no) + " of bundle " + name;
-                return;
+                jobs.put(nullptr);
             }
 
-            if ( line_name.length() == 0 )
+            for (thread &t : threads)
             {
-                LOG(WARNING) << "Name missing for resource at line " + to_string(line_no) + " of bundle " + name;
-                return;
+                t.join();
             }
+        }
+    };
+
+    static _bundle_worker_pool _bundle_workers;
 
-            if ( line_path.length() == 0 && kind != TIMER_RESOURCE )
+    static void _decode_bundle_entries()
+    {
+        while (true)
+        {
+            _bundle_entry *entry = _bundle_workers.jobs.take();
+            if ( entry == nullptr ) return;
+
+            if ( entry->pack )
             {
-                LOG(WARNING) << "Name missing for resource at line " + to_string(line_no) + " of bundle " + name;
-                return;
+                const char *data;
+                size_t size;
+                vector<char> buffer;
+
+                if ( sk_read_pack_entry(entry->pack, entry->file_path, data, size, buffer) )
+                {
+                    if ( entry->details.kind == IMAGE_RESOURCE )
+                        entry->image = sk_decode_bitmap_from_memory(data, size);
+                    else
+                        entry->sound = sk_load_sound_data_from_memory(data, size, SGSD_SOUND_EFFECT);
+                }
             }
+            else if ( entry->details.kind == IMAGE_RESOURCE )
+                entry->image = sk_decode_bitmap(entry->file_path.c_str());
+            else
+                entry->sound = sk_load_sound_data(entry->file_path, SGSD_SOUND_EFFECT);
 
-            switch ( kind )
+            _ready_entries.put(entry);
+        }
+    }
+
+    static void _start_bundle_workers()
+    {
+        if ( _bundle_workers.threads.size() > 0 ) return;
+
+        unsigned int count = std::thread::hardware_concurrency();
+        count = std::max(MIN_BUNDLE_WORKERS, std::min(MAX_BUNDLE_WORKERS, count));
+
+        for (unsigned int i = 0; i < count; i++)
+        {
+            _bundle_workers.threads.push_back(thread(_decode_bundle_entries));
+        }
+    }
+
+    static void _feed_bundle_workers()
+    {
+        while ( _jobs_in_flight < MAX_BUNDLE_JOBS_IN_FLIGHT and _pending_jobs.size() > 0 )
+        {
+            _bundle_workers.jobs.put(_pending_jobs.front());
+            _pending_jobs.pop_front();
+            _jobs_in_flight++;
+        }
+    }
+
+    /**
+     * Finds the file for a resource that will be decoded by a worker,
+     * returning false if it does not exist.
+     */
+    static bool _resolve_bundle_file(_bundle_entry *entry)
+    {
+        if ( entry->pack )
+        {
+            entry->file_path = _pack_entry_name(entry->details.kind, entry->details.path);
+            if ( sk_pack_has_entry(entry->pack, entry->file_path) ) return true;
+
+            // Resources left out of the pack are loaded from their files
+            entry->pack = nullptr;
+        }
+
+        entry->file_path = find_resource_file(entry->details.path, entry->details.kind);
+
+        if ( entry->file_path.empty() )
+        {
+            LOG(WARNING) << cat({ "Unable to locate file for ", entry->details.name, " (", path_to_resource(entry->details.path, entry->details.kind), ")"});
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Registers the resource for an entry on the main thread, creating the
+     * textures for decoded images, then records the entry as done.
+     */
+    static void _finish_bundle_entry(_bundle_entry *entry)
+    {
+        const _bundle_line &details = entry->details;
+        _bundle_load *load = entry->load;
+        bool loaded = false;
+
+        // Resources read from a pack have no file to reload from, so they are never evicted
+        string file_path = entry->pack ? "" : entry->file_path;
+
+        if ( load->cancelled )
+        {
+            if ( entry->image ) sk_free_decoded_bitmap(entry->image);
+            if ( entry->sound._data ) sk_close_sound_data(&entry->sound);
+        }
+        else if ( not entry->decode_on_worker )
+        {
+            // Nested bundles have already loaded in the background
+            if ( details.kind == BUNDLE_RESOURCE )
+                loaded = has_resource_bundle(details.name);
+            else
+                loaded = _load_bundle_resource(details, load->name, load->pack.get());
+        }
+        else if ( details.kind == IMAGE_RESOURCE )
+        {
+            if ( has_bitmap(details.name) )
             {
-                case BUNDLE_RESOURCE:
-                    load_resource_bundle(line_name, line_path);
-                    if ( ! has_resource_bundle(line_name) ) return;
-                    break;
-                case TIMER_RESOURCE:
-                    create_timer(line_name);
-                    break;
-                case IMAGE_RESOURCE:
-                    rb_load_bitmap(line_name, line_path);
-                    if ( ! has_resource_bundle(line_name) ) return;
-                    break;
-                case FONT_RESOURCE:
-                    load_font(line_name, line_path);
-                    if ( ! has_font(line_name) ) return;
-                    break;
-                case SOUND_RESOURCE:
-                    load_sound_effect(line_name, line_path);
-                    if ( ! has_sound_effect(line_name) ) return;
-                    break;
-                case MUSIC_RESOURCE:
-                    load_music(line_name, line_path);
-                    if ( ! has_music(line_name) ) return;
-                    break;
-                case ANIMATION_RESOURCE:
-                    load_animation_script(line_name, line_path);
-                    if ( ! has_animation_script(line_name) ) return;
-                    break;
-                default:
-                    return;
+                sk_free_decoded_bitmap(entry->image);
+                _set_bundle_bitmap_cells(bitmap_named(details.name), details, load->name);
+                loaded = true;
+            }
+            else if ( entry->image )
+            {
+                bitmap bmp = _create_loaded_bitmap(details.name, file_path, sk_bitmap_from_decoded(entry->image));
+                _set_bundle_bitmap_cells(bmp, details, load->name);
+                loaded = true;
+            }
+            else
+            {
+                LOG(WARNING) << cat({ "Error loading image for ", details.name, " (", entry->file_path, ")"});
             }
+        }
+        else
+        {
+            if ( has_sound_effect(details.name) )
+            {
+                sk_close_sound_data(&entry->sound);
+                loaded = true;
+            }
+            else
+            {
+                loaded = _create_loaded_sound_effect(details.name, file_path, entry->sound) != nullptr;
+            }
+        }
 
+        if ( loaded )
+        {
             bundled_resource br;
-            br.name = line_name;
-            br.kind = kind;
+            br.name = details.name;
+            br.kind = details.kind;
+
+            load->result.resources.push_back(br);
+        }
 
-            result.resources.push_back(br);
+        load->done++;
+        delete entry;
+    }
+
+    static void _start_bundle_load(const string &name, const vector<_bundle_line> &lines, std::shared_ptr<sk_pack> pack)
+    {
+        _bundle_load *load = new _bundle_load();
+        load->name = name;
+        load->total = lines.size();
+        load->done = 0;
+        load->pack = pack;
+        _bundle_loads[name] = load;
 
+        _start_bundle_workers();
+
+        for (const _bundle_line &details : lines)
+        {
+            _bundle_entry *entry = new _bundle_entry();
+            entry->load = load;
+            entry->details = details;
+            entry->pack = pack.get();
+            entry->image = nullptr;
+            entry->sound = { SGSD_UNKNOWN, nullptr, nullptr };
+            entry->decode_on_worker = details.kind == IMAGE_RESOURCE or (details.kind == SOUND_RESOURCE and audio_ready());
+
+            if ( details.kind == BUNDLE_RESOURCE )
+            {
+                string entry_name = _pack_entry_name(BUNDLE_RESOURCE, details.path);
+                vector<_bundle_line> nested;
+
+                if ( pack and sk_pack_has_entry(pack.get(), entry_name) )
+                {
+                    if ( has_resource_bundle(details.name) or _bundle_loads.count(details.name) > 0 )
+                        LOG(WARNING) << "Attempting to load resource bundle twice.";
+                    else if ( _read_packed_bundle(details.name, entry_name, pack.get(), nested) )
+                        _start_bundle_load(details.name, nested, pack);
+                }
+                else
+                    load_resource_bundle_async(details.name, details.path);
+
+                load->nested.push_back(entry);
+            }
+            else if ( not entry->decode_on_worker )
+            {
+                // Other resources are quick to load, so are loaded in turn on the main thread
+                _main_thread_entries.push_back(entry);
+            }
+            else if ( _resolve_bundle_file(entry) )
+            {
+                _pending_jobs.push_back(entry);
+            }
+            else
+            {
+                load->done++;
+                delete entry;
+            }
+        }
+
+        _feed_bundle_workers();
+    }
+
+    void load_resource_bundle_async(const string &name, const string &filename)
+    {
+        internal_sk_init();
+
+        if ( has_resource_bundle(name) or _bundle_loads.count(name) > 0 )
+        {
+            LOG(WARNING) << "Attempting to load resource bundle twice.";
+            return;
+        }
+
+        string path = resource_file_path(filename, BUNDLE_RESOURCE);
+
+        if ( path.empty() )
+        {
+            LOG(WARNING) << cat({ "Unable to locate bundle file for ", name, " (", path_to_resource(filename, BUNDLE_RESOURCE), ")"});
+            return;
+        }
+
+        vector<_bundle_line> lines;
+
+        if ( sk_is_pack_file(path) )
+        {
+            std::shared_ptr<sk_pack> pack(sk_open_pack(path), sk_close_pack);
+            if ( ! pack or ! _read_packed_bundle(name, PACK_ROOT_BUNDLE, pack.get(), lines) ) return;
+
+            _start_bundle_load(name, lines, pack);
             return;
+        }
+
+        ifstream input(path);
+        _read_bundle_lines(name, input, lines);
+
+        _start_bundle_load(name, lines, nullptr);
+    }
+
+    /**
+     * Discards the entries of a bundle that is loading, including its nested
+     * bundles. Entries already with a worker are discarded when they return.
+     */
+    static void _cancel_bundle_load(_bundle_load *load)
+    {
+        if ( load->cancelled ) return;
+        load->cancelled = true;
+
+        auto not_started = [load] (_bundle_entry *entry)
+        {
+            if ( entry->load != load ) return false;
+
+            load->done++;
+            delete entry;
+            return true;
         };
 
-        while (getline(input, line))
+        _pending_jobs.erase(std::remove_if(_pending_jobs.begin(), _pending_jobs.end(), not_started), _pending_jobs.end());
+        _main_thread_entries.erase(std::remove_if(_main_thread_entries.begin(), _main_thread_entries.end(), not_started), _main_thread_entries.end());
+
+        for (_bundle_entry *nested : load->nested)
         {
-            line_no = line_no + 1;
+            auto nested_load = _bundle_loads.find(nested->details.name);
+            if ( nested_load != _bundle_loads.end() ) _cancel_bundle_load(nested_load->second);
+        }
+    }
 
-            line = trim(line);
-            if (line.length() == 0) continue;  //skip empty lines
-            if (line.substr(0,2) == "//") continue; //skip lines starting with //
+    static void _free_bundle_resources(const resource_bundle &bndl);
+
+    void process_bundle_loads()
+    {
+        if ( _bundle_loads.empty() ) return;
 
-            process_line();
+        // Finish the entries that are ready, until this frame's time is used up
+        auto start = std::chrono::steady_clock::now();
+        while ( true )
+        {
+            _bundle_entry *entry;
+            if ( _ready_entries.try_take(entry) )
+            {
+                _jobs_in_flight--;
+            }
+            else if ( _main_thread_entries.size() > 0 )
+            {
+                entry = _main_thread_entries.front();
+                _main_thread_entries.pop_front();
+            }
+            else break;
+
+            _finish_bundle_entry(entry);
+
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            if ( elapsed.count() >= BUNDLE_UPLOAD_BUDGET_MS ) break;
         }
 
-        _resource_bundles[name] = result;
+        _feed_bundle_workers();
+
+        for (auto it = _bundle_loads.begin(); it != _bundle_loads.end(); )
+        {
+            _bundle_load *load = it->second;
+
+            for (auto nested = load->nested.begin(); nested != load->nested.end(); )
+            {
+                if ( _bundle_loads.count((*nested)->details.name) == 0 )
+                {
+                    _finish_bundle_entry(*nested);
+                    nested = load->nested.erase(nested);
+                }
+                else ++nested;
+            }
+
+            if ( load->done == load->total )
+            {
+                if ( load->cancelled )
+                    _free_bundle_resources(load->result);
+                else
+                    _resource_bundles[load->name] = load->result;
+
+                delete load;
+                it = _bundle_loads.erase(it);
+            }
+            else ++it;
+        }
+    }
+
+    float bundle_load_progress(const string &name)
+    {
+        if ( has_resource_bundle(name) ) return 1.0f;
+
+        auto it = _bundle_loads.find(name);
+        if ( it == _bundle_loads.end() )
+        {
+            LOG(WARNING) << "Attempting to get load progress of unknown resource bundle named " + name;
+            return 0.0f;
+        }
+
+        _bundle_load *load = it->second;
+        float done = load->done;
+
+        // Include the progress of nested bundles that are still loading
+        for (_bundle_entry *nested : load->nested)
+        {
+            auto nested_load = _bundle_loads.find(nested->details.name);
+            if ( nested_load != _bundle_loads.end() and nested_load->second->total > 0 )
+                done += static_cast<float>(nested_load->second->done) / nested_load->second->total;
+        }
+
+        return load->total == 0 ? 1.0f : done / load->total;
     }
 
     void free_resource_bundle(const string name)
     {
         if ( ! has_resource_bundle(name) )
         {
+            auto loading = _bundle_loads.find(name);
+            if ( loading != _bundle_loads.end() )
+            {
+                // Its resources are freed when the work already started has finished
+                _cancel_bundle_load(loading->second);
+                return;
+            }
+
             LOG(WARNING) << "Attempting to free unloaded resource bundle named " + name;
             return;
         }
@@ -199,6 +882,11 @@ namespace splashkit_lib
         resource_bundle bndl = _resource_bundles[name];
         _resource_bundles.erase(name);
 
+        _free_bundle_resources(bndl);
+    }
+
+    static void _free_bundle_resources(const resource_bundle &bndl)
+    {
         for( bundled_resource br : bndl.resources )
         {
             switch ( br.kind )
@@ -232,6 +920,11 @@ namespace splashkit_lib
 
     void free_all_resource_bundles()
     {
+        for (auto &loading : _bundle_loads)
+        {
+            _cancel_bundle_load(loading.second);
+        }
+
         for (unsigned long i = _resource_bundles.size(); i > 0 ; i--)
         {
             free_resource_bundle(_resource_bundles.begin()->first);
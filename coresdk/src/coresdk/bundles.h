@@ -111,11 +111,52 @@ namespace splashkit_lib
      *    BUNDLE,another bundle,another.txt
      *    ```
      *
+     * The filename can also be a resource pack created with
+     * `pack_resource_bundle` (or the `skpak` tool). The bundle's resources are
+     * then read from the single pack file rather than from `Resources`.
+     *
      * @param name      The name of the bundle when it is loaded.
      * @param filename  The filename to load.
      */
     void load_resource_bundle(const string &name, const string &filename);
 
+    /**
+     * Starts loading the resource bundle in the background, returning
+     * straight away. Images and sound effects are read and decoded on worker
+     * threads, while the remaining work is done a few milliseconds at a time
+     * each time you call `process_events`, so a loading screen can keep
+     * animating. Use `bundle_load_progress` to check how much has loaded.
+     *
+     * The bundle file uses the same format as `load_resource_bundle`.
+     *
+     * @param name      The name of the bundle when it is loaded.
+     * @param filename  The filename to load.
+     */
+    void load_resource_bundle_async(const string &name, const string &filename);
+
+    /**
+     * Returns how much of a resource bundle has loaded, from 0 to 1. Bundles
+     * loaded with `load_resource_bundle_async` are ready to use once this
+     * reaches 1.
+     *
+     * @param name  The name of the resource bundle.
+     * @returns     The fraction of the bundle's resources that have loaded.
+     */
+    float bundle_load_progress(const string &name);
+
+    /**
+     * Packs a resource bundle, along with the files for its resources and any
+     * bundles it loads, into a single resource pack file. The pack can be
+     * loaded in place of the bundle file with `load_resource_bundle`, which
+     * avoids opening a file for each resource.
+     *
+     * @param filename      The bundle file to pack.
+     * @param pack_filename The path of the resource pack to create.
+     * @param compress      Compress the files that get smaller when compressed.
+     * @returns             True if the pack was written.
+     */
+    bool pack_resource_bundle(const string &filename, const string &pack_filename, bool compress);
+
     /**
      * Returns true when the named resource bundle has already been loaded.
      *
@@ -127,7 +168,9 @@ namespace splashkit_lib
     /**
      * When you are finished with the resources in a bundle, you can free them all
      * by calling this procedure. It will free the resource bundle and all of the
-     * associated resources.
+     * associated resources. A bundle still loading in the background stops
+     * loading, and the resources it has loaded are freed as `process_events`
+     * finishes the work already started.
      *
      * @param name  The name of the resource bundle to be freed
      */
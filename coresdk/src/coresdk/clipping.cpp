@@ -43,6 +43,7 @@ namespace splashkit_lib
             return;
         }
 
+        use_bitmap(bmp);
         _push_clip(bmp->image, r);
     }
 
@@ -87,6 +88,7 @@ namespace splashkit_lib
             return;
         }
 
+        use_bitmap(bmp);
         _reset_clip(bmp->image);
     }
 
@@ -141,6 +143,7 @@ namespace splashkit_lib
             return;
         }
 
+        use_bitmap(bmp);
         _pop_clip(bmp->image);
     }
 
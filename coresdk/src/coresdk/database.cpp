@@ -11,18 +11,22 @@
 #include "resources.h"
 #include "backend_types.h"
 #include "utility_functions.h"
+#include "json_driver.h"
 
 #include <vector>
 #include <algorithm>
 #include <iostream>
 #include <map>
+#include <unordered_map>
+#include <cstdio>
 
 using std::vector;
 using std::map;
+using std::unordered_map;
 
 namespace splashkit_lib
 {
-    static map<string, database> _databases;
+    static unordered_map<string, database> _databases;
     static vector<query_result> _queries_vector;
 
     bool has_database(string name)
@@ -68,18 +72,380 @@ namespace splashkit_lib
 
         sk_step_statement(result);
 
-        _queries_vector.push_back(result);
+        add_to_slots(_queries_vector, result, &sk_query_result::_slot);
 
         return result;
     }
     
+    query_result run_sql_async(database db, const string &sql)
+    {
+        if ( INVALID_PTR(db, DATABASE_PTR))
+        {
+            LOG(WARNING) << "Attempting to run async query on invalid database.";
+            return nullptr;
+        }
+
+        query_result result = new sk_query_result();
+        result->id = QUERY_PTR;
+        result->_database = db;
+
+        sk_run_query_async(result, sql);
+
+        add_to_slots(_queries_vector, result, &sk_query_result::_slot);
+
+        return result;
+    }
+
+    bool query_ready(query_result result)
+    {
+        if ( INVALID_PTR(result, QUERY_PTR))
+        {
+            LOG(WARNING) << "Attempting to check if an invalid query is ready.";
+            return false;
+        }
+
+        return sk_query_complete(result);
+    }
+
+    void query_wait(query_result result)
+    {
+        if ( INVALID_PTR(result, QUERY_PTR))
+        {
+            LOG(WARNING) << "Attempting to wait for an invalid query.";
+            return;
+        }
+
+        sk_wait_for_query(result);
+    }
+
+    json database_stats(database db)
+    {
+        json result = create_json();
+
+        if ( INVALID_PTR(db, DATABASE_PTR))
+        {
+            LOG(WARNING) << "Attempting to get stats of invalid database.";
+            return result;
+        }
+
+        vector<sk_statement_stats> stats = sk_database_stats(db);
+
+        // slowest in total first, as these are where time is best saved
+        std::sort(stats.begin(), stats.end(), [] (const sk_statement_stats &a, const sk_statement_stats &b) { return a.total_ms > b.total_ms; });
+
+        backend_json statements = backend_json::array();
+        for (const sk_statement_stats &statement : stats)
+        {
+            statements.push_back({
+                {"sql", statement.sql},
+                {"count", statement.count},
+                {"total_ms", statement.total_ms},
+                {"avg_ms", statement.count > 0 ? statement.total_ms / statement.count : 0.0},
+                {"max_ms", statement.max_ms},
+                {"rows_returned", statement.rows_returned},
+                {"vm_steps", statement.vm_steps},
+                {"full_scan_steps", statement.full_scan_steps},
+                {"sorts", statement.sorts},
+                {"auto_indexes", statement.auto_indexes}
+            });
+        }
+
+        result->data["statements"] = std::move(statements);
+        return result;
+    }
+
+    void reset_database_stats(database db)
+    {
+        if ( INVALID_PTR(db, DATABASE_PTR))
+        {
+            LOG(WARNING) << "Attempting to reset stats of invalid database.";
+            return;
+        }
+
+        sk_reset_database_stats(db);
+    }
+
+    void set_database_profiling(database db, bool enabled)
+    {
+        if ( INVALID_PTR(db, DATABASE_PTR))
+        {
+            LOG(WARNING) << "Attempting to set profiling of invalid database.";
+            return;
+        }
+
+        sk_set_database_profiling(db, enabled);
+    }
+
+    void set_slow_query_threshold(database db, double milliseconds)
+    {
+        if ( INVALID_PTR(db, DATABASE_PTR))
+        {
+            LOG(WARNING) << "Attempting to set slow query threshold of invalid database.";
+            return;
+        }
+
+        sk_set_slow_query_threshold(db, milliseconds);
+    }
+
+    query_result prepare_sql(database db, const string &sql)
+    {
+        if ( INVALID_PTR(db, DATABASE_PTR))
+        {
+            LOG(WARNING) << "Attempting to prepare query on invalid database.";
+            return nullptr;
+        }
+
+        query_result result = new sk_query_result();
+        *result = sk_prepare_statement(db, sql);
+
+        if ( not sk_query_success(result) )
+        {
+            LOG(WARNING) << "Failed to prepare query: " << sk_db_error_message(result);
+        }
+
+        add_to_slots(_queries_vector, result, &sk_query_result::_slot);
+
+        return result;
+    }
+
+    bool bind_int(query_result query, int index, int value)
+    {
+        if ( INVALID_PTR(query, QUERY_PTR))
+        {
+            LOG(WARNING) << "Attempting to bind a value to an invalid query.";
+            return false;
+        }
+
+        return sk_bind_int(query, index, value);
+    }
+
+    bool bind_double(query_result query, int index, double value)
+    {
+        if ( INVALID_PTR(query, QUERY_PTR))
+        {
+            LOG(WARNING) << "Attempting to bind a value to an invalid query.";
+            return false;
+        }
+
+        return sk_bind_double(query, index, value);
+    }
+
+    bool bind_text(query_result query, int index, const string &value)
+    {
+        if ( INVALID_PTR(query, QUERY_PTR))
+        {
+            LOG(WARNING) << "Attempting to bind a value to an invalid query.";
+            return false;
+        }
+
+        return sk_bind_text(query, index, value);
+    }
+
+    bool bind_blob(query_result query, int index, const vector<int8_t> &data)
+    {
+        if ( INVALID_PTR(query, QUERY_PTR))
+        {
+            LOG(WARNING) << "Attempting to bind a value to an invalid query.";
+            return false;
+        }
+
+        return sk_bind_blob(query, index, data.data(), static_cast<int>(data.size()));
+    }
+
+    bool step_query(query_result query)
+    {
+        if ( INVALID_PTR(query, QUERY_PTR))
+        {
+            LOG(WARNING) << "Attempting to step an invalid query.";
+            return false;
+        }
+        if ( INVALID_PTR(query->_database, DATABASE_PTR))
+        {
+            LOG(WARNING) << "Attempting to step query when database has been closed";
+            return false;
+        }
+        if ( query->_task )
+        {
+            LOG(WARNING) << "Attempting to step an async query.";
+            return false;
+        }
+
+        sk_step_statement(query);
+        return sk_query_success(query);
+    }
+
+    void reset_prepared_query(query_result query)
+    {
+        if ( INVALID_PTR(query, QUERY_PTR))
+        {
+            LOG(WARNING) << "Attempting to reset an invalid query.";
+            return;
+        }
+        if ( INVALID_PTR(query->_database, DATABASE_PTR))
+        {
+            LOG(WARNING) << "Attempting to reset query when database has been closed";
+            return;
+        }
+
+        sk_reset_prepared_statement(query);
+    }
+
+    bool begin_transaction(database db)
+    {
+        if ( INVALID_PTR(db, DATABASE_PTR))
+        {
+            LOG(WARNING) << "Attempting to begin a transaction on invalid database.";
+            return false;
+        }
+        if ( sk_in_transaction(db) )
+        {
+            LOG(WARNING) << "Attempting to begin a transaction when " << db->name << " is already in one.";
+            return false;
+        }
+
+        return sk_exec_sql(db, "BEGIN;");
+    }
+
+    bool commit_transaction(database db)
+    {
+        if ( INVALID_PTR(db, DATABASE_PTR))
+        {
+            LOG(WARNING) << "Attempting to commit a transaction on invalid database.";
+            return false;
+        }
+
+        return sk_exec_sql(db, "COMMIT;");
+    }
+
+    bool rollback_transaction(database db)
+    {
+        if ( INVALID_PTR(db, DATABASE_PTR))
+        {
+            LOG(WARNING) << "Attempting to roll back a transaction on invalid database.";
+            return false;
+        }
+
+        return sk_exec_sql(db, "ROLLBACK;");
+    }
+
+    /**
+     * Quotes a table or column name, so it can be used in sql built at
+     * runtime.
+     */
+    static string _quote_sql_identifier(const string &name)
+    {
+        string result = "\"";
+        for (char c : name)
+        {
+            if (c == '"') result += '"';
+            result += c;
+        }
+        return result + "\"";
+    }
+
+    int bulk_insert(database db, const string &table, const vector<string> &columns, const vector<vector<string>> &rows)
+    {
+        if ( INVALID_PTR(db, DATABASE_PTR))
+        {
+            LOG(WARNING) << "Attempting to insert rows into invalid database.";
+            return 0;
+        }
+        if ( columns.size() == 0 or rows.size() == 0 ) return 0;
+
+        string sql = "INSERT INTO " + _quote_sql_identifier(table) + " (";
+        string values = "VALUES (";
+        for (size_t i = 0; i < columns.size(); i++)
+        {
+            if (i > 0)
+            {
+                sql += ", ";
+                values += ", ";
+            }
+            sql += _quote_sql_identifier(columns[i]);
+            values += "?";
+        }
+        sql += ") " + values + ");";
+
+        // a savepoint works inside or outside of a transaction the caller has started
+        if ( not sk_exec_sql(db, "SAVEPOINT splashkit_bulk_insert;") ) return 0;
+
+        sk_query_result insert = sk_prepare_statement(db, sql);
+        bool success = sk_query_success(&insert);
+        if ( not success )
+        {
+            LOG(WARNING) << "Failed to prepare bulk insert into " << table << ": " << sk_db_error_message(&insert);
+        }
+
+        for (size_t r = 0; success and r < rows.size(); r++)
+        {
+            if ( rows[r].size() != columns.size() )
+            {
+                LOG(WARNING) << "Row " << r << " of bulk insert into " << table << " has " << rows[r].size() << " values, expected " << columns.size();
+                success = false;
+                break;
+            }
+
+            sk_reset_prepared_statement(&insert);
+            for (size_t c = 0; success and c < columns.size(); c++)
+            {
+                success = sk_bind_text(&insert, static_cast<int>(c + 1), rows[r][c]);
+            }
+
+            if ( success )
+            {
+                sk_step_statement(&insert);
+                success = sk_query_success(&insert);
+                if ( not success )
+                {
+                    LOG(WARNING) << "Failed to insert row " << r << " into " << table << ": " << sk_db_error_message(&insert);
+                }
+            }
+        }
+
+        sk_finalise_query(&insert);
+
+        if ( not success )
+        {
+            sk_exec_sql(db, "ROLLBACK TO splashkit_bulk_insert;");
+            sk_exec_sql(db, "RELEASE splashkit_bulk_insert;");
+            return 0;
+        }
+
+        sk_exec_sql(db, "RELEASE splashkit_bulk_insert;");
+        return static_cast<int>(rows.size());
+    }
+
+    bool configure_database(database db, bool write_ahead_log, bool synchronous_normal, int cache_size_kb, int mmap_size_mb)
+    {
+        if ( INVALID_PTR(db, DATABASE_PTR))
+        {
+            LOG(WARNING) << "Attempting to configure invalid database.";
+            return false;
+        }
+
+        bool success = true;
+
+        success = sk_exec_sql(db, write_ahead_log ? "PRAGMA journal_mode=WAL;" : "PRAGMA journal_mode=DELETE;") and success;
+        success = sk_exec_sql(db, synchronous_normal ? "PRAGMA synchronous=NORMAL;" : "PRAGMA synchronous=FULL;") and success;
+
+        // a negative cache size is in KiB rather than pages
+        if ( cache_size_kb > 0 )
+            success = sk_exec_sql(db, "PRAGMA cache_size=-" + std::to_string(cache_size_kb) + ";") and success;
+
+        if ( mmap_size_mb >= 0 )
+            success = sk_exec_sql(db, "PRAGMA mmap_size=" + std::to_string(static_cast<long long>(mmap_size_mb) * 1024 * 1024) + ";") and success;
+
+        return success;
+    }
+
     string error_message(query_result query)
     {
         if ( INVALID_PTR(query, QUERY_PTR))
         {
             return "Attempting to get error message for invalid query result";
         }
-        
+
+        sk_wait_for_query(query);
         return sk_db_error_message(query);
     }
 
@@ -98,14 +464,9 @@ namespace splashkit_lib
 
         notify_of_free(query);
 
-        vector<query_result>::iterator it;
-
-        it = find (_queries_vector.begin(), _queries_vector.end(), query);
-        if (it != _queries_vector.end())
+        if (remove_from_slots(_queries_vector, query, &sk_query_result::_slot))
         {
-            auto index = std::distance(_queries_vector.begin(), it);
-            sk_finalise_query(_queries_vector.at(index));
-            _queries_vector.erase(it);
+            sk_finalise_query(query);
             delete(query);
         }
         else
@@ -132,6 +493,11 @@ namespace splashkit_lib
             LOG(WARNING) << "Attempting to get next row when database has been closed for this query";
             return false;
         }
+        if ( result->_task )
+        {
+            LOG(WARNING) << "Attempting to get next row of an async query. Read its rows with query_fetched_numbers or query_fetched_text.";
+            return false;
+        }
         
         return sk_query_get_next_row(result);
     }
@@ -144,6 +510,7 @@ namespace splashkit_lib
             return false;
         }
 
+        sk_wait_for_query(result);
         return sk_query_has_data(result);
     }
 
@@ -170,6 +537,11 @@ namespace splashkit_lib
             LOG(WARNING) << "Attempting to reset query when database has been closed";
             return;
         }
+        if ( result->_task )
+        {
+            LOG(WARNING) << "Attempting to reset an async query. Use run_sql_async to run it again.";
+            return;
+        }
 
         sk_reset_query_statement(result);
     }
@@ -218,6 +590,144 @@ namespace splashkit_lib
         return sk_query_read_column_bool(result, col);
     }
 
+    int query_fetch_rows(query_result result, int max_rows)
+    {
+        if ( INVALID_PTR(result, QUERY_PTR))
+        {
+            LOG(WARNING) << "Attempting to fetch rows from invalid query.";
+            return 0;
+        }
+        if ( result->_task )
+        {
+            // async queries read all of their rows when they run
+            sk_wait_for_query(result);
+            return result->_fetched_rows;
+        }
+        if ( INVALID_PTR(result->_database, DATABASE_PTR))
+        {
+            LOG(WARNING) << "Attempting to fetch rows when database has been closed for this query";
+            return 0;
+        }
+
+        return sk_query_fetch_rows(result, max_rows);
+    }
+
+    int query_fetch_all(query_result result)
+    {
+        return query_fetch_rows(result, -1);
+    }
+
+    vector<string> query_fetched_column_names(query_result result)
+    {
+        vector<string> names;
+
+        if ( INVALID_PTR(result, QUERY_PTR))
+        {
+            LOG(WARNING) << "Attempting to access invalid query to read fetched columns.";
+            return names;
+        }
+
+        sk_wait_for_query(result);
+
+        for (const sk_query_column &column : result->_columns)
+        {
+            names.push_back(column.name);
+        }
+
+        return names;
+    }
+
+    /**
+     * Returns the fetched column, or nullptr with a warning if the query or
+     * column is not valid.
+     */
+    static sk_query_column *_fetched_column(query_result result, int col)
+    {
+        if ( INVALID_PTR(result, QUERY_PTR))
+        {
+            LOG(WARNING) << "Attempting to access invalid query to read fetched columns.";
+            return nullptr;
+        }
+
+        sk_wait_for_query(result);
+
+        if ( col < 0 or col >= static_cast<int>(result->_columns.size()) )
+        {
+            LOG(WARNING) << "Failed to read fetched column " << col << ". Ensure rows have been fetched, and there are sufficient columns.";
+            return nullptr;
+        }
+
+        return &result->_columns[col];
+    }
+
+    vector<double> query_fetched_numbers(query_result result, int col)
+    {
+        sk_query_column *column = _fetched_column(result, col);
+        if ( not column ) return vector<double>();
+
+        if ( column->type == SK_FLOAT_COLUMN ) return column->numbers;
+
+        vector<double> numbers;
+        numbers.reserve(column->nulls.size());
+        for (int row = 0; row < static_cast<int>(column->nulls.size()); row++)
+        {
+            numbers.push_back(sk_query_column_number(*column, row));
+        }
+        return numbers;
+    }
+
+    vector<string> query_fetched_text(query_result result, int col)
+    {
+        sk_query_column *column = _fetched_column(result, col);
+        if ( not column ) return vector<string>();
+
+        if ( column->type == SK_TEXT_COLUMN ) return column->text;
+
+        vector<string> text;
+        text.reserve(column->nulls.size());
+        for (int row = 0; row < static_cast<int>(column->nulls.size()); row++)
+        {
+            text.push_back(sk_query_column_text(*column, row));
+        }
+        return text;
+    }
+
+    vector<bool> query_fetched_nulls(query_result result, int col)
+    {
+        sk_query_column *column = _fetched_column(result, col);
+        if ( not column ) return vector<bool>();
+
+        return column->nulls;
+    }
+
+    json query_fetch_json(query_result result, int max_rows)
+    {
+        json j = create_json();
+
+        backend_json rows = backend_json::array();
+        int count = query_fetch_rows(result, max_rows);
+
+        for (int row = 0; row < count; row++)
+        {
+            backend_json values = backend_json::object();
+            for (const sk_query_column &column : result->_columns)
+            {
+                if ( column.nulls[row] )
+                    values[column.name] = nullptr;
+                else if ( column.type == SK_TEXT_COLUMN )
+                    values[column.name] = column.text[row];
+                else if ( column.type == SK_INTEGER_COLUMN )
+                    values[column.name] = column.integers[row];
+                else
+                    values[column.name] = column.numbers[row];
+            }
+            rows.push_back(std::move(values));
+        }
+
+        j->data["rows"] = std::move(rows);
+        return j;
+    }
+
     string query_type_of_col(query_result result, int col)
     {
         if ( INVALID_PTR(result, QUERY_PTR))
@@ -236,6 +746,8 @@ namespace splashkit_lib
             LOG(WARNING) << "Attempting to access invalid query to read row.";
             return 0;
         }
+
+        sk_wait_for_query(result);
         return sk_query_success(result);
     }
 
@@ -269,6 +781,13 @@ namespace splashkit_lib
             notify_of_free(db_to_close);
 
             _databases.erase(db_to_close->name);
+
+            // queries the user still holds must not use the closed connection or the freed database
+            for (query_result query : _queries_vector)
+            {
+                if (query->_database == db_to_close) sk_detach_query(query);
+            }
+
             sk_close_database(db_to_close);
             db_to_close->id = NONE_PTR;  // ensure future use of this pointer will fail...
             delete(db_to_close);
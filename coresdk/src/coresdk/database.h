@@ -17,7 +17,13 @@
 #define database_h
 
 #include <string>
+#include <vector>
+#include <cstdint>
+
+#include "json.h"
+
 using std::string;
+using std::vector;
 
 namespace splashkit_lib
 {
@@ -150,6 +156,312 @@ namespace splashkit_lib
      */
     query_result run_sql(string database_name, string sql);
 
+    /**
+     * Starts running the `sql` in the background, so that slow queries do
+     * not hold up the game loop. Use `query_ready` to check when it has
+     * finished, or `query_wait` to wait for it. All of the rows are read
+     * when the query runs; access them with `query_fetched_numbers`,
+     * `query_fetched_text` or `query_fetch_json`.
+     *
+     * Queries that change the database are run one at a time, in the order
+     * they were started. Queries that only read data run in parallel, and
+     * may run before earlier changes have been made - wait for a change to
+     * finish before starting a query that needs to see it.
+     *
+     * Running an async query switches the database file to use a write
+     * ahead log, so readers can run while changes are written. This is saved
+     * in the database file, so it remains after the database is closed.
+     * Use `configure_database` to return to a rollback journal once the
+     * async queries are no longer needed.
+     *
+     * @param db    The database to perform `sql` on.
+     * @param sql   The sql statement to perform on `db`.
+     *
+     * @returns Returns the `query_result`, which is ready once the query
+     *          has finished.
+     *
+     * @attribute class   database
+     * @attribute method  run_sql_async
+     * @attribute self    db
+     */
+    query_result run_sql_async(database db, const string &sql);
+
+    /**
+     * Checks if a query started with `run_sql_async` has finished. Queries
+     * run with `run_sql` are always ready.
+     *
+     * @param db_result The query to check.
+     *
+     * @returns Returns `true` if the query has finished.
+     *
+     * @attribute class   query_result
+     * @attribute getter  ready
+     * @attribute self    db_result
+     */
+    bool query_ready(query_result db_result);
+
+    /**
+     * Waits for a query started with `run_sql_async` to finish.
+     *
+     * @param db_result The query to wait for.
+     *
+     * @attribute class   query_result
+     * @attribute method  wait
+     * @attribute self    db_result
+     */
+    void query_wait(query_result db_result);
+
+    /**
+     * Compiles the `sql` into a query that can be run many times. Use `?` or
+     * `?NNN` in the sql where values will be bound with `bind_int`,
+     * `bind_double`, `bind_text` or `bind_blob`, then run it with
+     * `step_query`. Values bound this way never need to be escaped. Call
+     * `reset_prepared_query` to run the query again. Compiled statements
+     * are cached, so preparing the same sql again is fast.
+     *
+     * @param db    The database the query will run on.
+     * @param sql   The sql statement to prepare.
+     *
+     * @returns Returns the `query_result` for the prepared query, which has
+     *          not yet been run.
+     *
+     * @attribute class   database
+     * @attribute method  prepare_sql
+     * @attribute self    db
+     */
+    query_result prepare_sql(database db, const string &sql);
+
+    /**
+     * Binds an integer value to a parameter in a prepared query.
+     *
+     * @param query The prepared query.
+     * @param index The index of the parameter, starting at 1 for the first `?`.
+     * @param value The value to bind.
+     *
+     * @returns Returns `true` if the value was bound.
+     *
+     * @attribute class   query_result
+     * @attribute method  bind_int
+     * @attribute self    query
+     */
+    bool bind_int(query_result query, int index, int value);
+
+    /**
+     * Binds a double value to a parameter in a prepared query.
+     *
+     * @param query The prepared query.
+     * @param index The index of the parameter, starting at 1 for the first `?`.
+     * @param value The value to bind.
+     *
+     * @returns Returns `true` if the value was bound.
+     *
+     * @attribute class   query_result
+     * @attribute method  bind_double
+     * @attribute self    query
+     */
+    bool bind_double(query_result query, int index, double value);
+
+    /**
+     * Binds a text value to a parameter in a prepared query.
+     *
+     * @param query The prepared query.
+     * @param index The index of the parameter, starting at 1 for the first `?`.
+     * @param value The value to bind.
+     *
+     * @returns Returns `true` if the value was bound.
+     *
+     * @attribute class   query_result
+     * @attribute method  bind_text
+     * @attribute self    query
+     */
+    bool bind_text(query_result query, int index, const string &value);
+
+    /**
+     * Binds binary data to a parameter in a prepared query.
+     *
+     * @param query The prepared query.
+     * @param index The index of the parameter, starting at 1 for the first `?`.
+     * @param data  The data to bind.
+     *
+     * @returns Returns `true` if the data was bound.
+     *
+     * @attribute class   query_result
+     * @attribute method  bind_blob
+     * @attribute self    query
+     */
+    bool bind_blob(query_result query, int index, const vector<int8_t> &data);
+
+    /**
+     * Runs a prepared query until it has the next row of data, or until it
+     * has finished. Use `has_row` to check if there is a row to read.
+     *
+     * @param query The prepared query to run.
+     *
+     * @returns Returns `true` if the query ran without error.
+     *
+     * @attribute class   query_result
+     * @attribute method  step
+     * @attribute self    query
+     */
+    bool step_query(query_result query);
+
+    /**
+     * Resets a prepared query so that it can be run again with `step_query`.
+     * The bound values are kept, and can be replaced before it is run.
+     *
+     * @param query The prepared query to reset.
+     *
+     * @attribute class   query_result
+     * @attribute method  reset_prepared
+     * @attribute self    query
+     */
+    void reset_prepared_query(query_result query);
+
+    /**
+     * Starts a transaction on the database. The changes made by the queries
+     * that follow are saved together when `commit_transaction` is called,
+     * which is much faster than saving each change as it is made. Use
+     * `rollback_transaction` to discard the changes instead.
+     *
+     * @param db The database to start the transaction on.
+     *
+     * @returns Returns `true` if the transaction was started.
+     *
+     * @attribute class   database
+     * @attribute method  begin_transaction
+     * @attribute self    db
+     */
+    bool begin_transaction(database db);
+
+    /**
+     * Saves the changes made in the current transaction.
+     *
+     * @param db The database with the transaction to commit.
+     *
+     * @returns Returns `true` if the changes were saved.
+     *
+     * @attribute class   database
+     * @attribute method  commit_transaction
+     * @attribute self    db
+     */
+    bool commit_transaction(database db);
+
+    /**
+     * Discards the changes made in the current transaction.
+     *
+     * @param db The database with the transaction to roll back.
+     *
+     * @returns Returns `true` if the changes were discarded.
+     *
+     * @attribute class   database
+     * @attribute method  rollback_transaction
+     * @attribute self    db
+     */
+    bool rollback_transaction(database db);
+
+    /**
+     * Inserts many rows into a table using a single prepared query. All of
+     * the rows are inserted together, so if any row fails none of them are
+     * inserted. Values are passed as text, and are converted by the column
+     * types of the table.
+     *
+     * @param db        The database to insert the rows into.
+     * @param table     The name of the table.
+     * @param columns   The names of the columns the values are for.
+     * @param rows      The rows to insert, each with a value for each column.
+     *
+     * @returns Returns the number of rows inserted.
+     *
+     * @attribute class   database
+     * @attribute method  bulk_insert
+     * @attribute self    db
+     */
+    int bulk_insert(database db, const string &table, const vector<string> &columns, const vector<vector<string>> &rows);
+
+    /**
+     * Configures how the database writes its changes to disk. Write ahead
+     * logging lets readers continue while data is written, and normal
+     * synchronisation only waits for the disk at checkpoints. Together they
+     * make writes much faster, at the risk of losing the last transactions
+     * (but not corrupting the database) if the computer loses power.
+     *
+     * @param db                    The database to configure.
+     * @param write_ahead_log       Use a write ahead log, instead of a rollback journal.
+     * @param synchronous_normal    Use normal, rather than full, synchronisation.
+     * @param cache_size_kb         The size of the page cache in kilobytes, or 0 to keep the current size.
+     * @param mmap_size_mb          The amount of the file to access with memory mapping in megabytes, 0 to turn memory mapping off, or -1 to keep the current setting.
+     *
+     * @returns Returns `true` if all of the settings were applied.
+     *
+     * @attribute class   database
+     * @attribute method  configure
+     * @attribute self    db
+     */
+    bool configure_database(database db, bool write_ahead_log, bool synchronous_normal, int cache_size_kb, int mmap_size_mb);
+
+    /**
+     * Turns on or off gathering statistics about the statements run on the
+     * database, which can then be read with `database_stats`. Statistics are
+     * off by default, as gathering them adds work to every row returned.
+     *
+     * @param db      The database to profile.
+     * @param enabled True to gather statistics, false to stop.
+     *
+     * @attribute class   database
+     * @attribute setter  profiling
+     * @attribute self    db
+     */
+    void set_database_profiling(database db, bool enabled);
+
+    /**
+     * Returns the statistics SplashKit has gathered about the statements
+     * run on the database while profiling was on, see
+     * `set_database_profiling`. The json object has a "statements" array, with
+     * the statements that have taken the most time in total first. Each
+     * statement has its "sql", the number of times it was run ("count"),
+     * its "total_ms", "avg_ms" and "max_ms" run times, and the
+     * "rows_returned". The "vm_steps" count the steps SQLite took to run the
+     * statement, which grows with the rows it scanned. The "full_scan_steps",
+     * "sorts" and "auto_indexes" counts show work that an index on the table
+     * could avoid.
+     *
+     * @param db The database to get the statistics of.
+     *
+     * @returns Returns a new json object containing the statistics.
+     *
+     * @attribute class   database
+     * @attribute getter  stats
+     * @attribute self    db
+     */
+    json database_stats(database db);
+
+    /**
+     * Clears the statistics gathered about the statements run on the database.
+     *
+     * @param db The database to reset the statistics of.
+     *
+     * @attribute class   database
+     * @attribute method  reset_stats
+     * @attribute self    db
+     */
+    void reset_database_stats(database db);
+
+    /**
+     * Logs a warning for each statement that takes longer than the threshold
+     * to run, along with the query plan SQLite used for it. The plan shows
+     * where tables are scanned rather than searched with an index. The
+     * warning is logged as the statement finishes. This does not need
+     * profiling to be turned on.
+     *
+     * @param db            The database to log slow queries for.
+     * @param milliseconds  The time a statement must take to be logged, or 0 to stop logging.
+     *
+     * @attribute class   database
+     * @attribute setter  slow_query_threshold
+     * @attribute self    db
+     */
+    void set_slow_query_threshold(database db, double milliseconds);
+
     /**
      * Frees all of the databases which have been loaded.
      *
@@ -275,6 +587,115 @@ namespace splashkit_lib
      */
     bool query_column_for_bool(query_result db_result, int col);
 
+    /**
+     * Reads up to `max_rows` rows from the `query_result`, starting at the
+     * current row, and stores them by column. Use `query_fetched_numbers`
+     * and `query_fetched_text` to get all of the values in a column at
+     * once. The query moves to the row after the last one read, so calling
+     * this again reads the next batch of rows.
+     *
+     * @param db_result The `query_result` to read the rows from.
+     * @param max_rows  The maximum number of rows to read.
+     *
+     * @returns Returns the number of rows read.
+     *
+     * @attribute class   query_result
+     * @attribute method  fetch_rows
+     * @attribute self    db_result
+     */
+    int query_fetch_rows(query_result db_result, int max_rows);
+
+    /**
+     * Reads all of the remaining rows from the `query_result`, and stores
+     * them by column. Use `query_fetched_numbers` and `query_fetched_text`
+     * to get all of the values in a column at once.
+     *
+     * @param db_result The `query_result` to read the rows from.
+     *
+     * @returns Returns the number of rows read.
+     *
+     * @attribute class   query_result
+     * @attribute method  fetch_all
+     * @attribute self    db_result
+     */
+    int query_fetch_all(query_result db_result);
+
+    /**
+     * Returns the names of the columns read by the last fetch.
+     *
+     * @param db_result The `query_result` that rows were fetched from.
+     *
+     * @returns Returns the names of the columns.
+     *
+     * @attribute class   query_result
+     * @attribute getter  fetched_column_names
+     * @attribute self    db_result
+     */
+    vector<string> query_fetched_column_names(query_result db_result);
+
+    /**
+     * Returns the values in a column of the rows read by the last fetch, as
+     * numbers. This is suited to `INTEGER` and `FLOAT` columns.
+     *
+     * @param db_result The `query_result` that rows were fetched from.
+     * @param col       The column to get the values of.
+     *
+     * @returns Returns a value for each row that was fetched.
+     *
+     * @attribute class   query_result
+     * @attribute method  fetched_numbers
+     * @attribute self    db_result
+     */
+    vector<double> query_fetched_numbers(query_result db_result, int col);
+
+    /**
+     * Returns the values in a column of the rows read by the last fetch, as
+     * text. Integers are read exactly, so this suits ids too large to be
+     * held exactly by `query_fetched_numbers`.
+     *
+     * @param db_result The `query_result` that rows were fetched from.
+     * @param col       The column to get the values of.
+     *
+     * @returns Returns a value for each row that was fetched.
+     *
+     * @attribute class   query_result
+     * @attribute method  fetched_text
+     * @attribute self    db_result
+     */
+    vector<string> query_fetched_text(query_result db_result, int col);
+
+    /**
+     * Returns which values in a column of the rows read by the last fetch
+     * are null. Null values read as 0 from `query_fetched_numbers`, and as
+     * an empty string from `query_fetched_text`.
+     *
+     * @param db_result The `query_result` that rows were fetched from.
+     * @param col       The column to check.
+     *
+     * @returns Returns true for each fetched row where the value is null.
+     *
+     * @attribute class   query_result
+     * @attribute method  fetched_nulls
+     * @attribute self    db_result
+     */
+    vector<bool> query_fetched_nulls(query_result db_result, int col);
+
+    /**
+     * Reads up to `max_rows` rows from the `query_result` into a json object.
+     * The rows are in an array with the key "rows", with each row an object
+     * mapping the column names to their values. Null values are json nulls.
+     *
+     * @param db_result The `query_result` to read the rows from.
+     * @param max_rows  The maximum number of rows to read, or -1 to read all remaining rows.
+     *
+     * @returns Returns a new json object containing the rows.
+     *
+     * @attribute class   query_result
+     * @attribute method  fetch_json
+     * @attribute self    db_result
+     */
+    json query_fetch_json(query_result db_result, int max_rows);
+
     /**
      * Queries a given column in the current row of the `query_result` for the data type at its postition.
      *
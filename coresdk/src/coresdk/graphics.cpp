@@ -129,6 +129,7 @@ namespace splashkit_lib
             return;
         }
 
+        use_bitmap(bmp);
         _save_surface(bmp->image, basename);
     }
 
@@ -14,15 +14,20 @@
 #include "resources.h"
 
 #include <map>
+#include <unordered_map>
 #include <cstdlib>
 #include <cmath>
 
 using std::map;
+using std::unordered_map;
 using std::to_string;
 
 namespace splashkit_lib
 {
-    static map<string, bitmap> _bitmaps;
+    static unordered_map<string, bitmap> _bitmaps;
+
+    // The next number to try when making a unique name from each bitmap name
+    static unordered_map<string, int> _bitmap_name_counters;
 
     void setup_collision_mask(bitmap bmp)
     {
@@ -32,6 +37,8 @@ namespace splashkit_lib
             return;
         }
         
+        use_bitmap(bmp);
+
         int *pixels;
         int sz;
         int r, c;
@@ -60,6 +67,51 @@ namespace splashkit_lib
     }
     
 
+    // Estimates the texture memory used by the bitmap
+    static size_t _bitmap_memory(bitmap bmp)
+    {
+        return 4 * static_cast<size_t>(bmp->image.surface.width) * static_cast<size_t>(bmp->image.surface.height);
+    }
+
+    /**
+     * Frees the bitmap's surface, leaving the bitmap to be loaded again from
+     * its file. Bitmaps that have been drawn on, or share an atlas page, are
+     * kept.
+     */
+    static bool _evict_bitmap(void *resource)
+    {
+        bitmap bmp = static_cast<bitmap>(resource);
+
+        if ( bmp->filename.empty() ) return false;
+        if ( sk_bitmap_drawn_on(&bmp->image.surface) or sk_in_atlas(&bmp->image.surface) ) return false;
+
+        int width = bmp->image.surface.width, height = bmp->image.surface.height;
+        sk_close_drawing_surface(&bmp->image.surface);
+
+        // Keep the size, so the bitmap's details can still be read
+        bmp->image.surface.width = width;
+        bmp->image.surface.height = height;
+        return true;
+    }
+
+    void use_bitmap(bitmap bmp)
+    {
+        if ( bmp->image.surface._data == nullptr )
+        {
+            sk_drawing_surface surface = sk_load_bitmap(bmp->filename.c_str());
+            if ( not surface._data )
+            {
+                LOG(WARNING) << cat({ "Error reloading image for ", bmp->name, " (", bmp->filename, ")"});
+                return;
+            }
+
+            bmp->image.surface = surface;
+            track_resource_memory(IMAGE_RESOURCE, bmp, _bitmap_memory(bmp), _evict_bitmap);
+        }
+        else
+            resource_used(IMAGE_RESOURCE, bmp);
+    }
+
     bool has_bitmap(string name)
     {
         return _bitmaps.count(name) > 0;
@@ -71,33 +123,52 @@ namespace splashkit_lib
             return _bitmaps[name];
         else
         {
-            string filename = path_to_resource(name, IMAGE_RESOURCE);
-
-            if ( file_exists(filename) or file_exists(name))
+            if ( has_resource_file(name, IMAGE_RESOURCE) )
                 return load_bitmap(name, name);
             return nullptr;
         }
     }
 
 
+    /**
+     * Registers a newly loaded surface as a bitmap with the given name.
+     */
+    bitmap _create_loaded_bitmap(const string &name, const string &file_path, const sk_drawing_surface &surface)
+    {
+        bitmap result = new_resource<_bitmap_data>();
+        result->image.surface = surface;
+
+        result->id         = BITMAP_PTR;
+        result->cell_w     = surface.width;
+        result->cell_h     = surface.height;
+        result->cell_cols  = 1;
+        result->cell_rows  = 1;
+        result->cell_count = 1;
+        result->pixel_mask = nullptr;
+
+        result->name       = name;
+        result->filename   = file_path;
+
+        setup_collision_mask(result);
+
+        _bitmaps[name] = result;
+        track_resource_memory(IMAGE_RESOURCE, result, _bitmap_memory(result), _evict_bitmap);
+
+        return result;
+    }
+
     bitmap load_bitmap(string name, string filename)
     {
         if (has_bitmap(name)) return bitmap_named(name);
 
         sk_drawing_surface surface;
-        bitmap result = nullptr;
 
-        string file_path = filename;
+        string file_path = find_resource_file(filename, IMAGE_RESOURCE);
 
-        if ( ! file_exists(file_path) )
+        if ( file_path.empty() )
         {
-            file_path = path_to_resource(filename, IMAGE_RESOURCE);
-
-            if ( ! file_exists(file_path) )
-            {
-                LOG(WARNING) << cat({ "Unable to locate file for ", name, " (", file_path, ")"});
-                return nullptr;
-            }
+            LOG(WARNING) << cat({ "Unable to locate file for ", name, " (", path_to_resource(filename, IMAGE_RESOURCE), ")"});
+            return nullptr;
         }
 
         surface = sk_load_bitmap(file_path.c_str());
@@ -107,30 +178,31 @@ namespace splashkit_lib
             return nullptr;
         }
 
-        result = new _bitmap_data;
-        result->image.surface = surface;
-
-        result->id         = BITMAP_PTR;
-        result->cell_w     = surface.width;
-        result->cell_h     = surface.height;
-        result->cell_cols  = 1;
-        result->cell_rows  = 1;
-        result->cell_count = 1;
-        result->pixel_mask = nullptr;
+        return _create_loaded_bitmap(name, file_path, surface);
+    }
 
-        result->name       = name;
-        result->filename   = file_path;
+    bitmap load_bitmap_from_memory(const string &name, const char *data, unsigned long size)
+    {
+        if (has_bitmap(name)) return bitmap_named(name);
 
-        setup_collision_mask(result);
+        sk_drawing_surface surface = sk_load_bitmap_from_memory(data, size);
+        if ( not surface._data )
+        {
+            LOG(WARNING) << cat({ "Error loading image data for ", name });
+            return nullptr;
+        }
 
-        _bitmaps[name] = result;
+        return _create_loaded_bitmap(name, "", surface);
+    }
 
-        return result;
+    bitmap load_bitmap_from_memory(const string &name, const vector<int8_t> &data)
+    {
+        return load_bitmap_from_memory(name, reinterpret_cast<const char *>(data.data()), data.size());
     }
 
     bitmap create_bitmap(string name, int width, int height)
     {
-        bitmap result = new(_bitmap_data);
+        bitmap result = new_resource<_bitmap_data>();
 
         result->id = BITMAP_PTR;
         result->image.surface = sk_create_bitmap(width, height);
@@ -144,17 +216,12 @@ namespace splashkit_lib
 
         result->filename   = "";
 
-        int idx = 0;
-        string key = name;
-        while (has_bitmap(key))
-        {
-            key = name + to_string(idx);
-            idx++;
-        }
+        string key = unique_name(_bitmaps, _bitmap_name_counters, name);
 
         result->name       = key;
 
         _bitmaps[key] = result;
+        track_resource_memory(IMAGE_RESOURCE, result, _bitmap_memory(result), nullptr);
 
         return result;
     }
@@ -166,11 +233,12 @@ namespace splashkit_lib
             notify_of_free(bmp);
 
             _bitmaps.erase(bmp->name);
+            untrack_resource_memory(IMAGE_RESOURCE, bmp);
             sk_close_drawing_surface(&bmp->image.surface);
             bmp->id = NONE_PTR;  // ensure future use of this pointer will fail...
             if ( bmp->pixel_mask != nullptr )
                 free(bmp->pixel_mask);
-            delete(bmp);
+            delete_resource(bmp);
         }
         else
         {
@@ -181,6 +249,32 @@ namespace splashkit_lib
     void free_all_bitmaps()
     {
         FREE_ALL_FROM_MAP(_bitmaps, BITMAP_PTR, free_bitmap);
+        _bitmap_name_counters.clear();
+    }
+
+    bool atlas_add_bitmap(bitmap bmp)
+    {
+        if ( INVALID_PTR(bmp, BITMAP_PTR) )
+        {
+            LOG(WARNING) << "Attempting to add invalid bitmap to an atlas";
+            return false;
+        }
+
+        use_bitmap(bmp);
+
+        return sk_add_to_atlas(&bmp->image.surface);
+    }
+
+    bool atlas_add_bitmap(const string &name)
+    {
+        return atlas_add_bitmap(bitmap_named(name));
+    }
+
+    bool bitmap_in_atlas(bitmap bmp)
+    {
+        if ( INVALID_PTR(bmp, BITMAP_PTR) ) return false;
+
+        return sk_in_atlas(&bmp->image.surface);
     }
 
     string bitmap_filename(bitmap bmp)
@@ -205,6 +299,8 @@ namespace splashkit_lib
             return;
         }
 
+        use_bitmap(bmp);
+
         sk_clear_drawing_surface(&bmp->image.surface, clr);
     }
 
@@ -227,6 +323,8 @@ namespace splashkit_lib
             return;
         }
 
+        use_bitmap(bmp);
+
         double src_data[4];
         double dst_data[7];
         sk_renderer_flip flip;
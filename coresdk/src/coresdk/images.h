@@ -15,7 +15,10 @@
 #include "physics.h"
 
 #include <string>
+#include <vector>
+#include <cstdint>
 using std::string;
+using std::vector;
 
 namespace splashkit_lib
 {
@@ -34,6 +37,18 @@ namespace splashkit_lib
      */
     bitmap load_bitmap(string name, string filename);
 
+    /**
+     * Loads and returns a bitmap from image data that is already in memory,
+     * such as data received over the network. The data is the contents of
+     * an image file (png, jpg, etc.). The supplied `name` indicates the name
+     * to use to refer to this Bitmap in SplashKit.
+     *
+     * @param  name     The name of the bitmap resource in SplashKit
+     * @param  data     The contents of the image file
+     * @return          The loaded bitmap
+     */
+    bitmap load_bitmap_from_memory(const string &name, const vector<int8_t> &data);
+
     /**
      * Determines if SplashKit has a bitmap loaded for the supplied name.
      * This checks against all bitmaps loaded.
@@ -70,6 +85,43 @@ namespace splashkit_lib
      */
     void free_all_bitmaps();
 
+    /**
+     * Moves a loaded bitmap into a texture atlas, where it shares a large
+     * texture with other small bitmaps. Drawing many atlas bitmaps one after
+     * the other then needs far fewer texture switches. The bitmap is used as
+     * normal: drawing it, its cells and its collision mask are unchanged.
+     * Bitmaps larger than 512 pixels, and bitmaps that have been drawn on,
+     * are left as they are. Drawing onto a bitmap moves it out of the atlas.
+     *
+     * @param bmp   The bitmap to add to the atlas.
+     * @returns     True if the bitmap is now in an atlas.
+     *
+     * @attribute class bitmap
+     * @attribute method add_to_atlas
+     */
+    bool atlas_add_bitmap(bitmap bmp);
+
+    /**
+     * Moves the bitmap with the given name into a texture atlas.
+     *
+     * @param name  The name of the bitmap to add to the atlas.
+     * @returns     True if the bitmap is now in an atlas.
+     *
+     * @attribute suffix named
+     */
+    bool atlas_add_bitmap(const string &name);
+
+    /**
+     * Checks if the bitmap is drawn from a texture atlas.
+     *
+     * @param bmp   The bitmap to check.
+     * @returns     True if the bitmap is in an atlas.
+     *
+     * @attribute class bitmap
+     * @attribute getter in_atlas
+     */
+    bool bitmap_in_atlas(bitmap bmp);
+
     /**
      * Sets up the collision mask for a bitmap. This enables collision detection between
      * this bitmap and other bitmaps or shapes.
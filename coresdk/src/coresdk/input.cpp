@@ -10,6 +10,7 @@
 
 #include "geometry.h"
 #include "input_driver.h"
+#include "web_driver.h"
 #include "keyboard_input.h"
 #include "text.h"
 #include "utility_functions.h"
@@ -75,6 +76,12 @@ namespace splashkit_lib
         _mouse_start_process_events();
         
         sk_process_events();
+
+        // Let finished background web requests call back on this thread
+        sk_dispatch_http_callbacks();
+
+        // Upload the resources decoded for bundles loading in the background
+        process_bundle_loads();
     }
     
     bool quit_requested()
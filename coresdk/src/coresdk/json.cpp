@@ -13,19 +13,31 @@
 #include "core_driver.h"
 #include "utils.h"
 
+#include <fstream>
+
 using std::ofstream;
+using std::ifstream;
 
 namespace splashkit_lib
 {
     static vector<json> objects;
 
+    // The json objects created in each open arena, innermost last
+    static vector<vector<json>> _arenas;
+
     json create_json()
     {
         internal_sk_init();
 
-        sk_json* j = new sk_json;
+        sk_json* j = new_resource<sk_json>();
         j->id = JSON_PTR;
-        objects.push_back(j);
+        add_to_slots(objects, j, &sk_json::slot);
+
+        if (_arenas.size() > 0)
+        {
+            j->arena = _arenas.size() - 1;
+            add_to_slots(_arenas.back(), j, &sk_json::arena_slot);
+        }
 
         return j;
     };
@@ -53,20 +65,16 @@ namespace splashkit_lib
             return;
         }
 
-        for (auto it = objects.begin(); it != objects.end();)
+        if (remove_from_slots(objects, j, &sk_json::slot))
         {
-            if (*it == j)
-            {
-                notify_of_free(j);
+            notify_of_free(j);
 
-                sk_delete_json(*it);
-                it = objects.erase(it);
-                return;
-            }
-            else
+            if (j->arena >= 0)
             {
-                ++it;
+                remove_from_slots(_arenas[j->arena], j, &sk_json::arena_slot);
             }
+
+            sk_delete_json(j);
         }
     }
 
@@ -78,6 +86,34 @@ namespace splashkit_lib
         }
 
         objects.clear();
+
+        for (vector<json> &arena : _arenas)
+        {
+            arena.clear();
+        }
+    }
+
+    void json_arena_begin()
+    {
+        _arenas.push_back(vector<json>());
+    }
+
+    void json_arena_end()
+    {
+        if (_arenas.size() == 0)
+        {
+            LOG(WARNING) << "json_arena_end called without a matching json_arena_begin";
+            return;
+        }
+
+        // Free from the end, so no objects need to move within the arena
+        vector<json> &arena = _arenas.back();
+        while (arena.size() > 0)
+        {
+            free_json(arena.back());
+        }
+
+        _arenas.pop_back();
     }
 
     string json_to_string(json j)
@@ -96,20 +132,139 @@ namespace splashkit_lib
         return create_json(j_string);
     }
 
+    // Decodes json data in the given format from the input, throwing if it is not valid
+    static backend_json _json_decode(std::istream &input, json_format format)
+    {
+        switch (format)
+        {
+            case JSON_MESSAGEPACK:  return backend_json::from_msgpack(input);
+            case JSON_CBOR:         return backend_json::from_cbor(input);
+            case JSON_BSON:         return backend_json::from_bson(input);
+            default:                return backend_json::parse(input);
+        }
+    }
+
+    // Encodes the json data in the given format, throwing if it cannot be stored in that format
+    static vector<uint8_t> _json_encode(const backend_json &data, json_format format)
+    {
+        switch (format)
+        {
+            case JSON_MESSAGEPACK:  return backend_json::to_msgpack(data);
+            case JSON_CBOR:         return backend_json::to_cbor(data);
+            case JSON_BSON:         return backend_json::to_bson(data);
+            default:
+            {
+                string text = format == JSON_COMPACT_TEXT ? data.dump() : data.dump(4);
+                return vector<uint8_t>(text.begin(), text.end());
+            }
+        }
+    }
+
     json json_from_file(const string &filename)
     {
-        string result = file_as_string(filename, JSON_RESOURCE);
-        if (result.length() == 0)
+        return json_from_file(filename, JSON_TEXT);
+    };
+
+    json json_from_file(const string &filename, json_format format)
+    {
+        string path = path_to_resource(filename, JSON_RESOURCE);
+        ifstream input(path, std::ios::binary);
+        if (not input.is_open() or input.peek() == std::ifstream::traits_type::eof())
         {
             LOG(WARNING) << "No input received when trying to open json from file " \
                 << filename << ". Does the file exist?";
             return create_json();
         }
 
-        return json_from_string(result);
+        // Parse directly from the file, rather than reading it into a string first
+        json j = create_json();
+        try
+        {
+            j->data = _json_decode(input, format);
+        }
+        catch(...)
+        {
+            LOG(ERROR) << "Invalid JSON in file " << filename << " passed to json_from_file";
+        }
+
+        return j;
     };
 
+    // Passes values from the backend to the callback in a temporary json object
+    static bool _json_stream_value(const string &path, backend_json &value, json_stream_callback *on_value)
+    {
+        sk_json temp;
+        temp.id = JSON_PTR;
+        if (value.is_object())
+            temp.data = std::move(value);
+        else
+            temp.data["value"] = std::move(value);
+
+        bool result = on_value(path, &temp);
+
+        // Views taken in the callback cannot outlive the temporary object
+        sk_json_clear_views(&temp);
+        temp.id = NONE_PTR;
+        return result;
+    }
+
+    bool json_parse_stream(const string &filename, json_stream_callback *on_value)
+    {
+        return json_parse_stream(filename, vector<string>(), on_value);
+    }
+
+    bool json_parse_stream(const string &filename, const vector<string> &paths, json_stream_callback *on_value)
+    {
+        if (on_value == nullptr)
+        {
+            LOG(WARNING) << "Passed null callback to json_parse_stream";
+            return false;
+        }
+
+        string path = path_to_resource(filename, JSON_RESOURCE);
+        ifstream input(path);
+        if (not input.is_open())
+        {
+            LOG(WARNING) << "Unable to open json file " << filename << " in json_parse_stream. Does the file exist?";
+            return false;
+        }
+
+        return sk_json_parse_stream(input, paths, [on_value] (const string &value_path, backend_json &value)
+        {
+            return _json_stream_value(value_path, value, on_value);
+        });
+    }
+
+    json json_extract_paths(const string &filename, const vector<string> &paths)
+    {
+        json result = create_json();
+
+        string path = path_to_resource(filename, JSON_RESOURCE);
+        ifstream input(path);
+        if (not input.is_open())
+        {
+            LOG(WARNING) << "Unable to open json file " << filename << " in json_extract_paths. Does the file exist?";
+            return result;
+        }
+
+        // Without paths the stream reports every value, so only read when paths are given
+        if (paths.size() == 0) return result;
+
+        sk_json_parse_stream(input, paths, [result] (const string &value_path, backend_json &value)
+        {
+            result->data[value_path] = std::move(value);
+            return true;
+        });
+
+        return result;
+    }
+
     void json_to_file(json j, const string& filename)
+    {
+        json_to_file(j, filename, JSON_TEXT);
+    };
+
+    void json_to_file(json j, const string &filename, json_format format)
     {
         if (INVALID_PTR(j, JSON_PTR))
         {
@@ -117,13 +272,23 @@ namespace splashkit_lib
             return;
         }
 
+        vector<uint8_t> bytes;
+        try
+        {
+            bytes = _json_encode(j->data, format);
+        }
+        catch(...)
+        {
+            LOG(ERROR) << "Unable to encode json in the requested format in json_to_file";
+            return;
+        }
+
         string path = path_to_resource(filename, JSON_RESOURCE);
-        string j_string = json_to_string(j);
 
-        ofstream ofs(path);
+        ofstream ofs(path, std::ios::binary);
         if (ofs.is_open())
         {
-            ofs << j_string;
+            ofs.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
         }
         else
         {
@@ -132,6 +297,62 @@ namespace splashkit_lib
         }
     };
 
+    string json_to_compact_string(json j)
+    {
+        if (INVALID_PTR(j, JSON_PTR))
+        {
+            LOG(WARNING) << "Passed invalid json object to json_to_compact_string";
+            return "";
+        }
+
+        return j->data.dump();
+    }
+
+    vector<int8_t> json_to_bytes(json j, json_format format)
+    {
+        if (INVALID_PTR(j, JSON_PTR))
+        {
+            LOG(WARNING) << "Passed invalid json object to json_to_bytes";
+            return vector<int8_t>();
+        }
+
+        try
+        {
+            vector<uint8_t> bytes = _json_encode(j->data, format);
+            return vector<int8_t>(bytes.begin(), bytes.end());
+        }
+        catch(...)
+        {
+            LOG(ERROR) << "Unable to encode json in the requested format in json_to_bytes";
+            return vector<int8_t>();
+        }
+    }
+
+    json json_from_bytes(const vector<int8_t> &bytes, json_format format)
+    {
+        json j = create_json();
+
+        // The decoders need unsigned bytes, as values above 0x7f are read as negative otherwise
+        const uint8_t *begin = reinterpret_cast<const uint8_t *>(bytes.data());
+        const uint8_t *end = begin + bytes.size();
+        try
+        {
+            switch (format)
+            {
+                case JSON_MESSAGEPACK:  j->data = backend_json::from_msgpack(begin, end); break;
+                case JSON_CBOR:         j->data = backend_json::from_cbor(begin, end); break;
+                case JSON_BSON:         j->data = backend_json::from_bson(begin, end); break;
+                default:                j->data = backend_json::parse(begin, end); break;
+            }
+        }
+        catch(...)
+        {
+            LOG(ERROR) << "Invalid data passed to json_from_bytes";
+        }
+
+        return j;
+    }
+
     void json_set_string(json j, string key, string value)
     {
         sk_json_add_value(j, key, value);
@@ -247,12 +468,23 @@ namespace splashkit_lib
 
     void json_read_array(json j, string key, vector<json>& out)
     {
-        vector<backend_json> real;
-        sk_json_read_array(j, key, real);
+        if (INVALID_PTR(j, JSON_PTR))
+        {
+            LOG(WARNING) << "Passed an invalid json object to json_read_array";
+            return;
+        }
+
+        const backend_json *real = sk_json_find(j->data, key);
+        if (real == nullptr or not real->is_array())
+        {
+            LOG(ERROR) << "JSON key value is not an array. Has type " << json_type_to_string(real ? real->type() : backend_json::value_t::null);
+            return;
+        }
 
         out.clear();
+        out.reserve(real->size());
 
-        for (backend_json rj : real)
+        for (const backend_json &rj : *real)
         {
             json wj = create_json();
             wj->data = rj;
@@ -282,6 +514,190 @@ namespace splashkit_lib
         return static_cast<int>(j->data.size());
     }
 
+    bool json_has_path(json j, const string &path)
+    {
+        if (INVALID_PTR(j, JSON_PTR))
+        {
+            LOG(ERROR) << "Invalid json object passed to json_has_path";
+            return false;
+        }
+
+        return sk_json_at_pointer(j->data, path) != nullptr;
+    }
+
+    template<typename T>
+    static T _json_read_at(json j, const string &path, backend_json::value_t type)
+    {
+        if (INVALID_PTR(j, JSON_PTR))
+        {
+            LOG(ERROR) << "Invalid json object passed to json_read_x_at";
+            return T();
+        }
+
+        return sk_json_read_node<T>(sk_json_at_pointer(j->data, path), type);
+    }
+
+    string json_read_string_at(json j, const string &path)
+    {
+        return _json_read_at<string>(j, path, backend_json::value_t::string);
+    }
+
+    float json_read_number_at(json j, const string &path)
+    {
+        return _json_read_at<float>(j, path, backend_json::value_t::number_float);
+    }
+
+    int json_read_number_as_int_at(json j, const string &path)
+    {
+        return _json_read_at<int>(j, path, backend_json::value_t::number_integer);
+    }
+
+    double json_read_number_as_double_at(json j, const string &path)
+    {
+        return _json_read_at<double>(j, path, backend_json::value_t::number_float);
+    }
+
+    bool json_read_bool_at(json j, const string &path)
+    {
+        return _json_read_at<bool>(j, path, backend_json::value_t::boolean);
+    }
+
+    json_view json_view_at(json j, const string &path)
+    {
+        if (INVALID_PTR(j, JSON_PTR))
+        {
+            LOG(WARNING) << "Passed invalid json object to json_view_at";
+            return nullptr;
+        }
+
+        const backend_json *node = sk_json_at_pointer(j->data, path);
+        if (node == nullptr) return nullptr;
+
+        return sk_json_view_of(j, node);
+    }
+
+    json_view json_view_at(json_view view, const string &path)
+    {
+        if (INVALID_PTR(view, JSON_VIEW_PTR))
+        {
+            LOG(WARNING) << "Passed invalid json view to json_view_at";
+            return nullptr;
+        }
+
+        const backend_json *node = sk_json_at_pointer(*view->node, path);
+        if (node == nullptr) return nullptr;
+
+        return sk_json_view_of(view->owner, node);
+    }
+
+    json_view json_view_element(json_view view, int index)
+    {
+        if (INVALID_PTR(view, JSON_VIEW_PTR))
+        {
+            LOG(WARNING) << "Passed invalid json view to json_view_element";
+            return nullptr;
+        }
+
+        if (not view->node->is_array() or index < 0 or index >= view->node->size())
+        {
+            LOG(WARNING) << "Index " << index << " is not within the array in json_view_element";
+            return nullptr;
+        }
+
+        return sk_json_view_of(view->owner, &(*view->node)[index]);
+    }
+
+    int json_view_count(json_view view)
+    {
+        if (INVALID_PTR(view, JSON_VIEW_PTR))
+        {
+            LOG(WARNING) << "Passed invalid json view to json_view_count";
+            return 0;
+        }
+
+        if (view->node->is_array() or view->node->is_object())
+            return view->node->size();
+
+        return 0;
+    }
+
+    bool json_view_has_key(json_view view, const string &key)
+    {
+        if (INVALID_PTR(view, JSON_VIEW_PTR))
+        {
+            LOG(WARNING) << "Passed invalid json view to json_view_has_key";
+            return false;
+        }
+
+        return sk_json_find(*view->node, key) != nullptr;
+    }
+
+    template<typename T>
+    static T _json_view_read(json_view view, const string &key, backend_json::value_t type)
+    {
+        if (INVALID_PTR(view, JSON_VIEW_PTR))
+        {
+            LOG(ERROR) << "Invalid json view passed to json_view_read_x";
+            return T();
+        }
+
+        return sk_json_read_node<T>(sk_json_find(*view->node, key), type);
+    }
+
+    string json_view_read_string(json_view view, const string &key)
+    {
+        return _json_view_read<string>(view, key, backend_json::value_t::string);
+    }
+
+    float json_view_read_number(json_view view, const string &key)
+    {
+        return _json_view_read<float>(view, key, backend_json::value_t::number_float);
+    }
+
+    int json_view_read_number_as_int(json_view view, const string &key)
+    {
+        return _json_view_read<int>(view, key, backend_json::value_t::number_integer);
+    }
+
+    double json_view_read_number_as_double(json_view view, const string &key)
+    {
+        return _json_view_read<double>(view, key, backend_json::value_t::number_float);
+    }
+
+    bool json_view_read_bool(json_view view, const string &key)
+    {
+        return _json_view_read<bool>(view, key, backend_json::value_t::boolean);
+    }
+
+    json json_view_to_json(json_view view)
+    {
+        json result = create_json();
+
+        if (INVALID_PTR(view, JSON_VIEW_PTR))
+        {
+            LOG(WARNING) << "Passed invalid json view to json_view_to_json";
+            return result;
+        }
+
+        if (view->node->is_object())
+            result->data = *view->node;
+        else
+            result->data["value"] = *view->node;
+
+        return result;
+    }
+
+    void free_json_view(json_view view)
+    {
+        if (INVALID_PTR(view, JSON_VIEW_PTR))
+        {
+            LOG(WARNING) << "Passed invalid json view to free_json_view";
+            return;
+        }
+
+        sk_free_json_view(view);
+    }
+
     json json_from_color(color clr)
     {
         json result = create_json();
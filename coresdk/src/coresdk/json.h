@@ -20,6 +20,7 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 
 #include "types.h"
 
@@ -38,7 +39,8 @@ namespace splashkit_lib
      *
      *
      *   - created with `create_json()` or `create_json(string s)` or
-     *   `json_from_string(string s)` or `json_from_file(json j)`
+     *   `json_from_string(string s)` or `json_from_file(json j)` or
+     *   `json_from_bytes(bytes, format)`
      *
      *
      *   - and must be released using `free_json()` (to release a specific `json` object)
@@ -49,6 +51,20 @@ namespace splashkit_lib
      */
     typedef struct sk_json *json;
 
+    /**
+     * A `json_view` refers to a value inside a `json` object without copying
+     * it, so reading from deep within a large document costs a lookup rather
+     * than a copy of the subtree.
+     *
+     * Views are owned by the `json` object they were taken from. They are
+     * freed with that object, and whenever a value is set on it. A view that
+     * is no longer needed can be freed sooner with `free_json_view`. Using a
+     * view after it has been freed logs a warning.
+     *
+     * @attribute class json_view
+     */
+    typedef struct sk_json_view *json_view;
+
     /**
      * @brief Creates an empty `json` object.
      *
@@ -99,6 +115,27 @@ namespace splashkit_lib
      */
     void free_all_json();
 
+    /**
+     * Starts a json arena. Every `json` object created until the matching
+     * call to `json_arena_end` is freed by that call, so temporary objects
+     * such as those read from each network message can be released in one
+     * step. Arenas can be nested; each `json_arena_end` ends the most
+     * recently started arena.
+     *
+     * @attribute static json
+     * @attribute method arena_begin
+     */
+    void json_arena_begin();
+
+    /**
+     * Ends the most recently started json arena, freeing every `json`
+     * object created within it that has not already been freed.
+     *
+     * @attribute static json
+     * @attribute method arena_end
+     */
+    void json_arena_end();
+
     /**
      * Writes the `json` object to a JSON string stored in `Resources/json/filename`.
      *
@@ -110,6 +147,20 @@ namespace splashkit_lib
      */
     void json_to_file(json j, const string& filename);
 
+    /**
+     * Writes the `json` object to `Resources/json/filename` in the given
+     * format. Binary formats produce smaller files that load faster.
+     *
+     * @param j         The `json` object to be written to file.
+     * @param filename  The filename of the file to be stored in `Resources/json/`
+     * @param format    The format to write the file in.
+     *
+     * @attribute static json
+     * @attribute method to_file
+     * @attribute suffix in_format
+     */
+    void json_to_file(json j, const string &filename, json_format format);
+
     /**
      * Reads a `json` object from a JSON string stored in `Resources/json/filename`
      * and loads the data into the returned `json` object.
@@ -123,6 +174,74 @@ namespace splashkit_lib
      */
     json json_from_file(const string& filename);
 
+    /**
+     * Reads a `json` object from `Resources/json/filename`, where the file
+     * was written in the given format.
+     *
+     * @param filename  The filename of the file in `Resources/json/`.
+     * @param format    The format the file was written in.
+     *
+     * @returns Returns the `json` object loaded from the file.
+     *
+     * @attribute static json
+     * @attribute method from_file
+     * @attribute suffix in_format
+     */
+    json json_from_file(const string &filename, json_format format);
+
+    /**
+     * The json stream callback is called by `json_parse_stream` with each
+     * value read from the file. The `json` passed is only valid during the
+     * call; it is freed once the callback returns. Objects are passed as is,
+     * other values are wrapped in an object under the key "value".
+     *
+     * @param path  The JSON pointer to the value, for example "/players/3/score".
+     * @param value The value read from the file.
+     * @returns     Return false to stop reading the file.
+     */
+    typedef bool (json_stream_callback)(const string &path, json value);
+
+    /**
+     * Reads the JSON file stored in `Resources/json/filename` without loading
+     * the whole document, calling `on_value` with each number, string, boolean
+     * and null value in the file. Use this to process files too large to load
+     * with `json_from_file`.
+     *
+     * @param filename  The filename of the file in `Resources/json/`.
+     * @param on_value  The function to call with each value.
+     * @returns         False if the file could not be read or is invalid JSON.
+     */
+    bool json_parse_stream(const string &filename, json_stream_callback *on_value);
+
+    /**
+     * Reads the JSON file stored in `Resources/json/filename` without loading
+     * the whole document, calling `on_value` only with the values at the
+     * listed paths. Paths are JSON pointers, and a `*` segment matches any key
+     * or array index, so "/scores/*" reads each value in the scores array.
+     * Objects and arrays at a matching path are loaded in full.
+     *
+     * @param filename  The filename of the file in `Resources/json/`.
+     * @param paths     The JSON pointers to the values to read.
+     * @param on_value  The function to call with each matching value.
+     * @returns         False if the file could not be read or is invalid JSON.
+     *
+     * @attribute suffix  at_paths
+     */
+    bool json_parse_stream(const string &filename, const vector<string> &paths, json_stream_callback *on_value);
+
+    /**
+     * Reads only the values at the listed paths from the JSON file stored in
+     * `Resources/json/filename`, skipping the rest of the document. The
+     * returned `json` object maps the JSON pointer of each matching value to
+     * that value, for example "/players/3/score".
+     *
+     * @param filename  The filename of the file in `Resources/json/`.
+     * @param paths     The JSON pointers to the values to read, where a `*`
+     *                  segment matches any key or array index.
+     * @returns         A new `json` object with the values read.
+     */
+    json json_extract_paths(const string &filename, const vector<string> &paths);
+
     /**
      * Converts and returns the `json` object as a `string`.
      *
@@ -135,6 +254,48 @@ namespace splashkit_lib
      */
     string json_to_string(json j);
 
+    /**
+     * Converts and returns the `json` object as a `string` without any
+     * whitespace, which is smaller and faster to send than `json_to_string`.
+     *
+     * @param j The `json` object to be converted to a `string`.
+     *
+     * @returns Returns the `json` object as compact JSON text.
+     *
+     * @attribute static json
+     * @attribute method to_compact_json_string
+     */
+    string json_to_compact_string(json j);
+
+    /**
+     * Encodes the `json` object in the given format, for saving or sending
+     * over the network.
+     *
+     * @param j       The `json` object to encode.
+     * @param format  The format to encode the data in.
+     *
+     * @returns Returns the encoded bytes, or an empty list if the `json`
+     *          cannot be encoded in that format.
+     *
+     * @attribute static json
+     * @attribute method to_bytes
+     */
+    vector<int8_t> json_to_bytes(json j, json_format format);
+
+    /**
+     * Decodes a `json` object from bytes encoded in the given format.
+     *
+     * @param bytes   The encoded data, for example from `json_to_bytes`.
+     * @param format  The format the data was encoded in.
+     *
+     * @returns Returns a new `json` object with the decoded data. This is
+     *          empty if the bytes are not valid in that format.
+     *
+     * @attribute static json
+     * @attribute method from_bytes
+     */
+    json json_from_bytes(const vector<int8_t> &bytes, json_format format);
+
     /**
      * Reads a `json` object from a `string` in the JSON format.
      *
@@ -462,6 +623,267 @@ namespace splashkit_lib
      */
     int json_count_keys(json j);
 
+    /**
+     * Checks if the `json` object contains a value at the given path.
+     *
+     * @param j     The `json` object to check.
+     * @param path  A JSON pointer to the value, for example "/players/3/score".
+     *
+     * @returns Returns `true` if there is a value at the path.
+     *
+     * @attribute class json
+     * @attribute method has_path
+     * @attribute self j
+     */
+    bool json_has_path(json j, const string &path);
+
+    /**
+     * Reads a `string` value from the given path within the `json` object,
+     * without copying any of the objects along the way.
+     *
+     * @param j     The `json` object to read from.
+     * @param path  A JSON pointer to the value, for example "/players/3/name".
+     *
+     * @returns Returns the `string` value stored at the path.
+     *
+     * @attribute class json
+     * @attribute method read_string_at
+     * @attribute self j
+     */
+    string json_read_string_at(json j, const string &path);
+
+    /**
+     * Reads a `float` value from the given path within the `json` object,
+     * without copying any of the objects along the way.
+     *
+     * @param j     The `json` object to read from.
+     * @param path  A JSON pointer to the value, for example "/players/3/score".
+     *
+     * @returns Returns the `float` value stored at the path.
+     *
+     * @attribute class json
+     * @attribute method read_number_at
+     * @attribute self j
+     */
+    float json_read_number_at(json j, const string &path);
+
+    /**
+     * Reads an `int` value from the given path within the `json` object,
+     * without copying any of the objects along the way.
+     *
+     * @param j     The `json` object to read from.
+     * @param path  A JSON pointer to the value, for example "/players/3/score".
+     *
+     * @returns Returns the `int` value stored at the path.
+     *
+     * @attribute class json
+     * @attribute method read_number_as_int_at
+     * @attribute self j
+     */
+    int json_read_number_as_int_at(json j, const string &path);
+
+    /**
+     * Reads a `double` value from the given path within the `json` object,
+     * without copying any of the objects along the way.
+     *
+     * @param j     The `json` object to read from.
+     * @param path  A JSON pointer to the value, for example "/players/3/score".
+     *
+     * @returns Returns the `double` value stored at the path.
+     *
+     * @attribute class json
+     * @attribute method read_number_as_double_at
+     * @attribute self j
+     */
+    double json_read_number_as_double_at(json j, const string &path);
+
+    /**
+     * Reads a `bool` value from the given path within the `json` object,
+     * without copying any of the objects along the way.
+     *
+     * @param j     The `json` object to read from.
+     * @param path  A JSON pointer to the value, for example "/players/3/alive".
+     *
+     * @returns Returns the `bool` value stored at the path.
+     *
+     * @attribute class json
+     * @attribute method read_bool_at
+     * @attribute self j
+     */
+    bool json_read_bool_at(json j, const string &path);
+
+    /**
+     * Returns a view of the value at the given path within the `json` object.
+     * Unlike `json_read_object`, the value is not copied.
+     *
+     * @param j     The `json` object to take the view from.
+     * @param path  A JSON pointer to the value, or "" for the whole object.
+     *
+     * @returns Returns a view of the value, or `nullptr` if there is no value
+     *          at the path.
+     *
+     * @attribute class json
+     * @attribute method view_at
+     * @attribute self j
+     */
+    json_view json_view_at(json j, const string &path);
+
+    /**
+     * Returns a view of the value at the given path within the viewed value.
+     *
+     * @param view  The view to start from.
+     * @param path  A JSON pointer to the value, relative to the view.
+     *
+     * @returns Returns a view of the value, or `nullptr` if there is no value
+     *          at the path.
+     *
+     * @attribute class json_view
+     * @attribute method view_at
+     * @attribute self view
+     * @attribute suffix from_view
+     */
+    json_view json_view_at(json_view view, const string &path);
+
+    /**
+     * Returns a view of the value at the given index of the viewed array.
+     *
+     * @param view  A view of an array.
+     * @param index The index of the element.
+     *
+     * @returns Returns a view of the element, or `nullptr` if the index is
+     *          outside the array.
+     *
+     * @attribute class json_view
+     * @attribute method element
+     * @attribute self view
+     */
+    json_view json_view_element(json_view view, int index);
+
+    /**
+     * Returns the number of elements in the viewed array, or keys in the
+     * viewed object.
+     *
+     * @param view  The view to count.
+     *
+     * @returns The number of elements or keys, or 0 for other values.
+     *
+     * @attribute class json_view
+     * @attribute getter count
+     * @attribute self view
+     */
+    int json_view_count(json_view view);
+
+    /**
+     * Checks if the viewed object contains the given key.
+     *
+     * @param view  The view to check.
+     * @param key   The `string` key to be checked.
+     *
+     * @returns Returns `true` if the viewed object contains the key.
+     *
+     * @attribute class json_view
+     * @attribute method has_key
+     * @attribute self view
+     */
+    bool json_view_has_key(json_view view, const string &key);
+
+    /**
+     * Reads a `string` value from the viewed object for the given key.
+     *
+     * @param view  The view to read from.
+     * @param key   The `string` key used to find the value.
+     *
+     * @returns Returns the `string` value stored at the key.
+     *
+     * @attribute class json_view
+     * @attribute method read_string
+     * @attribute self view
+     */
+    string json_view_read_string(json_view view, const string &key);
+
+    /**
+     * Reads a `float` value from the viewed object for the given key.
+     *
+     * @param view  The view to read from.
+     * @param key   The `string` key used to find the value.
+     *
+     * @returns Returns the `float` value stored at the key.
+     *
+     * @attribute class json_view
+     * @attribute method read_number
+     * @attribute self view
+     */
+    float json_view_read_number(json_view view, const string &key);
+
+    /**
+     * Reads an `int` value from the viewed object for the given key.
+     *
+     * @param view  The view to read from.
+     * @param key   The `string` key used to find the value.
+     *
+     * @returns Returns the `int` value stored at the key.
+     *
+     * @attribute class json_view
+     * @attribute method read_number_as_int
+     * @attribute self view
+     */
+    int json_view_read_number_as_int(json_view view, const string &key);
+
+    /**
+     * Reads a `double` value from the viewed object for the given key.
+     *
+     * @param view  The view to read from.
+     * @param key   The `string` key used to find the value.
+     *
+     * @returns Returns the `double` value stored at the key.
+     *
+     * @attribute class json_view
+     * @attribute method read_number_as_double
+     * @attribute self view
+     */
+    double json_view_read_number_as_double(json_view view, const string &key);
+
+    /**
+     * Reads a `bool` value from the viewed object for the given key.
+     *
+     * @param view  The view to read from.
+     * @param key   The `string` key used to find the value.
+     *
+     * @returns Returns the `bool` value stored at the key.
+     *
+     * @attribute class json_view
+     * @attribute method read_bool
+     * @attribute self view
+     */
+    bool json_view_read_bool(json_view view, const string &key);
+
+    /**
+     * Copies the viewed value into a new `json` object, which remains valid
+     * after the view is freed. Values other than objects are stored under
+     * the key "value".
+     *
+     * @param view  The view to copy.
+     *
+     * @returns Returns a new `json` object with a copy of the viewed value.
+     *
+     * @attribute class json_view
+     * @attribute method to_json
+     * @attribute self view
+     */
+    json json_view_to_json(json_view view);
+
+    /**
+     * Frees the view, leaving the `json` object it was taken from unchanged.
+     * Taking a view of the same value again creates a new view.
+     *
+     * @param view  The view to free.
+     *
+     * @attribute class json_view
+     * @attribute destructor true
+     * @attribute self view
+     */
+    void free_json_view(json_view view);
+
     /**
      * Converts a `color` to a `json` object.
      *
@@ -14,9 +14,10 @@
 #include "music.h"
 
 #include <map>
+#include <unordered_map>
 namespace splashkit_lib
 {
-    static map<string, music> _music;
+    static std::unordered_map<string, music> _music;
 
     // While this is the same as sound data..
     // we want the compiler to make them different!
@@ -27,6 +28,65 @@ namespace splashkit_lib
         string filename, name;
     };
 
+    /**
+     * Closes the music, leaving it to be loaded again from its file. The
+     * current music stays loaded.
+     */
+    static bool _evict_music(void *resource)
+    {
+        music data = static_cast<music>(resource);
+
+        if ( data->filename.empty() or sk_current_music() == &data->audio ) return false;
+
+        sk_close_sound_data(&data->audio);
+        return true;
+    }
+
+    // Reloads the music if it was evicted, returning false if it cannot be loaded
+    static bool _use_music(music data)
+    {
+        if ( data->audio._data )
+        {
+            resource_used(MUSIC_RESOURCE, data);
+            return true;
+        }
+
+        data->audio = sk_load_sound_data(data->filename, SGSD_MUSIC);
+        if ( ! data->audio._data )
+        {
+            LOG(WARNING) << cat({ "Error reloading sound data for ", data->name, " (", data->filename, ")"});
+            return false;
+        }
+
+        track_resource_memory(MUSIC_RESOURCE, data, file_size(data->filename), _evict_music);
+        return true;
+    }
+
+    /**
+     * Registers newly loaded sound data as music with the given name. Music is
+     * streamed as it plays, so its memory is estimated from its encoded size.
+     */
+    music _create_loaded_music(const string &name, const string &file_path, const sk_sound_data &audio, unsigned long size)
+    {
+        // Unable to load music
+        if ( ! audio._data )
+        {
+            LOG(WARNING) << cat({ "Error loading sound data for ", name, " (", file_path, ")"});
+            return nullptr;
+        }
+
+        music result = new_resource<_music_data>();
+
+        result->id = MUSIC_PTR;
+        result->filename = file_path;
+        result->name = name;
+        result->audio = audio;
+
+        _music[name] = result;
+        track_resource_memory(MUSIC_RESOURCE, result, size, _evict_music);
+        return result;
+    }
+
     music load_music(const string &name, const string &filename)
     {
         if ( ! audio_ready() )
@@ -36,37 +96,32 @@ namespace splashkit_lib
         }
         if (has_music(name)) return music_named(name);
 
-        string file_path = filename;
+        string file_path = find_resource_file(filename, MUSIC_RESOURCE);
 
-        if ( ! file_exists(file_path) )
+        if ( file_path.empty() )
         {
-            file_path = path_to_resource(filename, MUSIC_RESOURCE);
-
-            if ( ! file_exists(file_path) )
-            {
-                LOG(WARNING) << cat({ "Unable to locate file for ", name, " (", file_path, ")"});
-                return nullptr;
-            }
+            LOG(WARNING) << cat({ "Unable to locate file for ", name, " (", path_to_resource(filename, MUSIC_RESOURCE), ")"});
+            return nullptr;
         }
 
-        music result = new _music_data();
-
-        result->id = MUSIC_PTR;
-        result->filename = file_path;
-        result->name = name;
-        result->audio = sk_load_sound_data(file_path, SGSD_MUSIC);
+        return _create_loaded_music(name, file_path, sk_load_sound_data(file_path, SGSD_MUSIC), file_size(file_path));
+    }
 
-        // Unable to load sound effect
-        if ( ! result->audio._data )
+    music load_music_from_memory(const string &name, const char *data, unsigned long size)
+    {
+        if ( ! audio_ready() )
         {
-            result->id = NONE_PTR;
-            delete result;
-            LOG(WARNING) << cat({ "Error loading sound data for ", name, " (", file_path, ")"});
+            LOG(ERROR) << "Attempting to load music when audio is closed.";
             return nullptr;
         }
+        if (has_music(name)) return music_named(name);
 
-        _music[name] = result;
-        return result;
+        return _create_loaded_music(name, "", sk_load_sound_data_from_memory(data, size, SGSD_MUSIC), size);
+    }
+
+    music load_music_from_memory(const string &name, const vector<int8_t> &data)
+    {
+        return load_music_from_memory(name, reinterpret_cast<const char *>(data.data()), data.size());
     }
 
     void free_music(music effect)
@@ -76,9 +131,10 @@ namespace splashkit_lib
             notify_of_free(effect);
 
             _music.erase(effect->name);
+            untrack_resource_memory(MUSIC_RESOURCE, effect);
             sk_close_sound_data(&effect->audio);
             effect->id = NONE_PTR;  // ensure future use of this pointer will fail...
-            delete(effect);
+            delete_resource(effect);
         }
         else
         {
@@ -118,9 +174,7 @@ namespace splashkit_lib
             return _music[name];
         else
         {
-            string filename = path_to_resource(name, MUSIC_RESOURCE);
-
-            if ( file_exists(filename) or file_exists(name))
+            if ( has_resource_file(name, MUSIC_RESOURCE) )
                 return load_music(name, name);
             return nullptr;
         }
@@ -137,6 +191,8 @@ namespace splashkit_lib
             return;
         }
 
+        if ( ! _use_music(data) ) return;
+
         sk_play_sound(&data->audio, times, volume);
     }
 
@@ -171,6 +227,8 @@ namespace splashkit_lib
             return;
         }
 
+        if ( ! _use_music(data) ) return;
+
         sk_fade_in(&data->audio, times, ms);
     }
 
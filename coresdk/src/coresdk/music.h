@@ -7,6 +7,13 @@
 
 #ifndef music_h
 #define music_h
+
+#include <string>
+#include <vector>
+#include <cstdint>
+using std::string;
+using std::vector;
+
 namespace splashkit_lib
 {
     /**
@@ -38,6 +45,17 @@ namespace splashkit_lib
      */
     music load_music(const string &name, const string &filename);
 
+    /**
+     * Loads and returns a music value from audio data already in memory, such
+     * as data received over the network. A copy of the data is kept while the
+     * music exists, as music is decoded as it plays.
+     *
+     * @param  name     The name of the resource for SplashKit
+     * @param  data     The contents of the music file
+     * @return          A new music resource
+     */
+    music load_music_from_memory(const string &name, const vector<int8_t> &data);
+
     /**
      * Releases the SplashKit resources associated with music.
      *
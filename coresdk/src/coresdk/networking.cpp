@@ -6,6 +6,7 @@
 
 #include "networking.h"
 #include "network_driver.h"
+#include "web_server_driver.h"
 #include "utility_functions.h"
 
 using std::endl;
@@ -835,6 +836,7 @@ namespace splashkit_lib
             return;
         }
 
+        sk_release_websocket_message(msg);
         msg->id = NONE_PTR;
         delete msg;
     }
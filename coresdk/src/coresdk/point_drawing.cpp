@@ -50,6 +50,8 @@ namespace splashkit_lib
             return COLOR_WHITE;
         }
 
+        use_bitmap(bmp);
+
         return sk_read_pixel(&bmp->image.surface, static_cast<int>(x), static_cast<int>(y));
     }
 
@@ -12,6 +12,11 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <iostream>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <climits>
+#include <filesystem>
 
 #ifdef __APPLE__
 #include <CoreFoundation/CoreFoundation.h>
@@ -38,11 +43,23 @@ namespace splashkit_lib
     static bool     _has_resources_path = false;
     static string   _resources_path = "";
 
+    // The files in the resources folder, from their path relative to the folder
+    static std::unordered_map<string, string> _resource_index;
+    static bool     _has_resource_index = false;
+
+    // The names probed by the *_named functions and not found, which are not checked again
+    // until the path changes
+    static std::unordered_set<string> _resource_misses;
+
     void set_resources_path(const string &path)
     {
         //    cout << "Setting path to: " << path << endl;
         _has_resources_path = true;
         _resources_path = path;
+
+        _resource_index.clear();
+        _resource_misses.clear();
+        _has_resource_index = false;
     }
 
     /// Try to set the resource path by exploring sub directories and parent
@@ -151,33 +168,224 @@ namespace splashkit_lib
         return _resources_path;
     }
 
-    string path_to_resources(resource_kind kind)
+    // The folder within Resources for each kind of resource
+    static string _resource_folder(resource_kind kind)
     {
-        string path = path_to_resources();
-
         switch(kind)
         {
-            case SOUND_RESOURCE:        return path_from({ path, "sounds" });
-            case MUSIC_RESOURCE:        return path_from({ path, "sounds" });
-            case BUNDLE_RESOURCE:       return path_from({ path, "bundles" });
-            case IMAGE_RESOURCE:        return path_from({ path, "images" });
-            case FONT_RESOURCE:         return path_from({ path, "fonts" });
-            case ANIMATION_RESOURCE:    return path_from({ path, "animations" });
-            case JSON_RESOURCE:         return path_from({ path, "json" });
-            case SERVER_RESOURCE:       return path_from({ path, "server" });
-            case DATABASE_RESOURCE:     return path_from({ path, "databases" });
-            case OTHER_RESOURCE:        return path;
+            case SOUND_RESOURCE:        return "sounds";
+            case MUSIC_RESOURCE:        return "sounds";
+            case BUNDLE_RESOURCE:       return "bundles";
+            case IMAGE_RESOURCE:        return "images";
+            case FONT_RESOURCE:         return "fonts";
+            case ANIMATION_RESOURCE:    return "animations";
+            case JSON_RESOURCE:         return "json";
+            case SERVER_RESOURCE:       return "server";
+            case DATABASE_RESOURCE:     return "databases";
+            case OTHER_RESOURCE:        return "";
             default:
                 LOG(WARNING) << "Attempting to get path to unknown resource kind.";
-                return path;
+                return "";
         }
     }
+
+    string path_to_resources(resource_kind kind)
+    {
+        string path = path_to_resources();
+        string folder = _resource_folder(kind);
+
+        if ( folder.empty() ) return path;
+        return path_from({ path, folder });
+    }
     
     string path_to_resource(const string &filename, resource_kind kind)
     {
         return path_from( { path_to_resources(kind) }, filename );
     }
 
+    // The index key for a file, which is its normalised path relative to the resources folder
+    static string _resource_index_key(const string &filename, resource_kind kind)
+    {
+        std::filesystem::path key(_resource_folder(kind));
+        key /= filename;
+        return key.lexically_normal().generic_string();
+    }
+
+    // Indexes every file in the resources folder and its sub folders
+    static void _build_resource_index()
+    {
+        _has_resource_index = true;
+
+        string root = path_to_resources();
+        if ( ! directory_exists(root) ) return;
+
+        std::filesystem::path root_path(root);
+        std::error_code error;
+
+        for (const string &dir : scan_dir_recursive(root))
+        {
+            for (const auto &entry : std::filesystem::directory_iterator(dir, error))
+            {
+                if ( ! entry.is_regular_file(error) ) continue;
+
+                string key = entry.path().lexically_relative(root_path).generic_string();
+                _resource_index[key] = entry.path().string();
+            }
+        }
+    }
+
+    string resource_file_path(const string &filename, resource_kind kind)
+    {
+        if ( ! _has_resource_index ) _build_resource_index();
+
+        string key = _resource_index_key(filename, kind);
+
+        auto found = _resource_index.find(key);
+        if ( found != _resource_index.end() ) return found->second;
+
+        // Files created since the folder was indexed are still found
+        string path = path_to_resource(filename, kind);
+        if ( ! file_exists(path) ) return "";
+
+        _resource_index[key] = path;
+        return path;
+    }
+
+    string find_resource_file(const string &filename, resource_kind kind)
+    {
+        if ( ! _has_resource_index ) _build_resource_index();
+
+        string key = _resource_index_key(filename, kind);
+
+        auto found = _resource_index.find(key);
+        if ( found != _resource_index.end() ) return found->second;
+
+        if ( file_exists(filename) ) return filename;
+
+        return resource_file_path(filename, kind);
+    }
+
+    bool has_resource_file(const string &name, resource_kind kind)
+    {
+        string key = _resource_index_key(name, kind);
+        if ( _resource_misses.count(key) > 0 ) return false;
+
+        if ( find_resource_file(name, kind).empty() )
+        {
+            _resource_misses.insert(key);
+            return false;
+        }
+
+        return true;
+    }
+
+    struct _tracked_resource
+    {
+        void                *resource;
+        size_t              bytes;
+        resource_evictor    *evict;
+    };
+
+    // The loaded resources of a kind, most recently used first
+    struct _resource_memory
+    {
+        size_t  budget = 0;
+        size_t  usage = 0;
+
+        std::list<_tracked_resource> by_use;
+        std::unordered_map<void *, std::list<_tracked_resource>::iterator> index;
+    };
+
+    static _resource_memory _resource_memory_by_kind[OTHER_RESOURCE + 1];
+
+    /**
+     * Evicts resources from the least recently used end until the kind is
+     * within its budget, skipping the resource being kept.
+     */
+    static void _apply_resource_budget(_resource_memory &memory, void *keep)
+    {
+        if ( memory.budget == 0 ) return;
+
+        auto it = memory.by_use.end();
+        while ( memory.usage > memory.budget and it != memory.by_use.begin() )
+        {
+            --it;
+            if ( it->resource == keep or not it->evict ) continue;
+
+            if ( it->evict(it->resource) )
+            {
+                memory.usage -= it->bytes;
+                memory.index.erase(it->resource);
+                it = memory.by_use.erase(it);
+            }
+        }
+    }
+
+    void track_resource_memory(resource_kind kind, void *resource, size_t bytes, resource_evictor *evict)
+    {
+        _resource_memory &memory = _resource_memory_by_kind[kind];
+
+        auto found = memory.index.find(resource);
+        if ( found != memory.index.end() )
+        {
+            memory.usage = memory.usage - found->second->bytes + bytes;
+            found->second->bytes = bytes;
+            memory.by_use.splice(memory.by_use.begin(), memory.by_use, found->second);
+        }
+        else
+        {
+            memory.by_use.push_front({ resource, bytes, evict });
+            memory.index[resource] = memory.by_use.begin();
+            memory.usage += bytes;
+        }
+
+        _apply_resource_budget(memory, resource);
+    }
+
+    void untrack_resource_memory(resource_kind kind, void *resource)
+    {
+        _resource_memory &memory = _resource_memory_by_kind[kind];
+
+        auto found = memory.index.find(resource);
+        if ( found == memory.index.end() ) return;
+
+        memory.usage -= found->second->bytes;
+        memory.by_use.erase(found->second);
+        memory.index.erase(found);
+    }
+
+    void resource_used(resource_kind kind, void *resource)
+    {
+        _resource_memory &memory = _resource_memory_by_kind[kind];
+
+        // Without a budget the order of use is not needed, so skip the lookup
+        if ( memory.budget == 0 ) return;
+
+        auto found = memory.index.find(resource);
+        if ( found != memory.index.end() )
+            memory.by_use.splice(memory.by_use.begin(), memory.by_use, found->second);
+    }
+
+    void set_resource_memory_budget(resource_kind kind, unsigned int bytes)
+    {
+        if ( kind < ANIMATION_RESOURCE or kind > OTHER_RESOURCE )
+        {
+            LOG(WARNING) << "Attempting to set memory budget for unknown resource kind.";
+            return;
+        }
+
+        _resource_memory_by_kind[kind].budget = bytes;
+        _apply_resource_budget(_resource_memory_by_kind[kind], nullptr);
+    }
+
+    unsigned int resource_memory_usage(resource_kind kind)
+    {
+        if ( kind < ANIMATION_RESOURCE or kind > OTHER_RESOURCE ) return 0;
+
+        size_t usage = _resource_memory_by_kind[kind].usage;
+        return usage > UINT_MAX ? UINT_MAX : static_cast<unsigned int>(usage);
+    }
+
     void register_free_notifier(free_notifier *fn)
     {
         _free_notifiers.push_back(fn);
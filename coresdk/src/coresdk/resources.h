@@ -74,7 +74,9 @@ namespace splashkit_lib
 
     /**
      * Sets the path to the SplashKit resources folder. Resource paths are then
-     * located within this folder.
+     * located within this folder. The files in the folder are indexed when a
+     * resource is first loaded from it, call this again to index files that
+     * have since been moved or deleted.
      *
      * @param path The file path to the SplashKit Resources folder.
      */
@@ -109,6 +111,29 @@ namespace splashkit_lib
      */
     string path_to_resource(const string &filename, resource_kind kind);
 
+    /**
+     * Sets how much memory the loaded resources of a kind can use. When loading
+     * a resource takes the kind over its budget, the least recently used
+     * resources are freed, and are loaded again from their files the next
+     * time they are used. Their handles stay valid throughout. Images, sounds,
+     * music and fonts can be budgeted. Resources loaded from memory or from a
+     * resource pack, bitmaps that have been drawn on and audio that is playing
+     * stay loaded.
+     *
+     * @param kind  The kind of resource to budget.
+     * @param bytes The memory the resources can use, or 0 for no limit.
+     */
+    void set_resource_memory_budget(resource_kind kind, unsigned int bytes);
+
+    /**
+     * Returns an estimate of the memory used by the loaded resources of a
+     * kind, such as the texture memory of images.
+     *
+     * @param kind  The kind of resource.
+     * @returns     The memory used in bytes.
+     */
+    unsigned int resource_memory_usage(resource_kind kind);
+
     /**
      * Register a function to be called when any resource is freed.
      *
@@ -13,12 +13,14 @@
 
 #include <iostream>
 #include <map>
+#include <unordered_map>
 
 using std::map;
+using std::unordered_map;
 
 namespace splashkit_lib
 {
-    static map<string, sound_effect> _sound_effects;
+    static unordered_map<string, sound_effect> _sound_effects;
 
     struct _sound_data
     {
@@ -28,6 +30,40 @@ namespace splashkit_lib
     };
 #include "sound.h"
 
+    /**
+     * Frees the effect's samples, leaving it to be loaded again from its file.
+     * Effects that are playing stay loaded.
+     */
+    static bool _evict_sound_effect(void *resource)
+    {
+        sound_effect effect = static_cast<sound_effect>(resource);
+
+        if ( effect->filename.empty() or sk_sound_playing(&effect->effect) ) return false;
+
+        sk_close_sound_data(&effect->effect);
+        return true;
+    }
+
+    // Reloads the effect if it was evicted, returning false if it cannot be loaded
+    static bool _use_sound_effect(sound_effect effect)
+    {
+        if ( effect->effect._data )
+        {
+            resource_used(SOUND_RESOURCE, effect);
+            return true;
+        }
+
+        effect->effect = sk_load_sound_data(effect->filename, SGSD_SOUND_EFFECT);
+        if ( ! effect->effect._data )
+        {
+            LOG(WARNING) << cat({ "Error reloading sound data for ", effect->name, " (", effect->filename, ")"});
+            return false;
+        }
+
+        track_resource_memory(SOUND_RESOURCE, effect, sk_sound_data_size(&effect->effect), _evict_sound_effect);
+        return true;
+    }
+
     bool has_sound_effect(const string &name)
     {
         return _sound_effects.count(name) > 0;
@@ -39,9 +75,7 @@ namespace splashkit_lib
             return _sound_effects[name];
         else
         {
-            string filename = path_to_resource(name, SOUND_RESOURCE);
-
-            if ( file_exists(filename) or file_exists(name))
+            if ( has_resource_file(name, SOUND_RESOURCE) )
                 return load_sound_effect(name, name);
             return nullptr;
         }
@@ -59,6 +93,30 @@ namespace splashkit_lib
         return effect->filename;
     }
 
+    /**
+     * Registers newly loaded sound data as a sound effect with the given name.
+     */
+    sound_effect _create_loaded_sound_effect(const string &name, const string &file_path, const sk_sound_data &effect)
+    {
+        // Unable to load sound effect
+        if ( ! effect._data )
+        {
+            LOG(WARNING) <<  cat({ "Error loading sound data for ", name, " (", file_path, ")"}) ;
+            return nullptr;
+        }
+
+        sound_effect result = new_resource<_sound_data>();
+
+        result->id = AUDIO_PTR;
+        result->filename = file_path;
+        result->name = name;
+        result->effect = effect;
+
+        _sound_effects[name] = result;
+        track_resource_memory(SOUND_RESOURCE, result, sk_sound_data_size(&result->effect), _evict_sound_effect);
+        return result;
+    }
+
     sound_effect load_sound_effect(const string &name, const string &filename)
     {
         if ( ! audio_ready() )
@@ -68,37 +126,32 @@ namespace splashkit_lib
         }
         if (has_sound_effect(name)) return sound_effect_named(name);
 
-        string file_path = filename;
+        string file_path = find_resource_file(filename, SOUND_RESOURCE);
 
-        if ( ! file_exists(file_path) )
+        if ( file_path.empty() )
         {
-            file_path = path_to_resource(filename, SOUND_RESOURCE);
-
-            if ( ! file_exists(file_path) )
-            {
-                LOG(WARNING) << cat({ "Unable to locate file for ", name, " (", file_path, ")"});
-                return nullptr;
-            }
+            LOG(WARNING) << cat({ "Unable to locate file for ", name, " (", path_to_resource(filename, SOUND_RESOURCE), ")"});
+            return nullptr;
         }
 
-        sound_effect result = new _sound_data();
-
-        result->id = AUDIO_PTR;
-        result->filename = file_path;
-        result->name = name;
-        result->effect = sk_load_sound_data(file_path, SGSD_SOUND_EFFECT);
+        return _create_loaded_sound_effect(name, file_path, sk_load_sound_data(file_path, SGSD_SOUND_EFFECT));
+    }
 
-        // Unable to load sound effect
-        if ( ! result->effect._data )
+    sound_effect load_sound_effect_from_memory(const string &name, const char *data, unsigned long size)
+    {
+        if ( ! audio_ready() )
         {
-            result->id = NONE_PTR;
-            delete result;
-            LOG(WARNING) <<  cat({ "Error loading sound data for ", name, " (", file_path, ")"}) ;
+            LOG(ERROR) << "Attempting to load sound effect when audio is closed.";
             return nullptr;
         }
+        if (has_sound_effect(name)) return sound_effect_named(name);
 
-        _sound_effects[name] = result;
-        return result;
+        return _create_loaded_sound_effect(name, "", sk_load_sound_data_from_memory(data, size, SGSD_SOUND_EFFECT));
+    }
+
+    sound_effect load_sound_effect_from_memory(const string &name, const vector<int8_t> &data)
+    {
+        return load_sound_effect_from_memory(name, reinterpret_cast<const char *>(data.data()), data.size());
     }
 
     void free_sound_effect(sound_effect effect)
@@ -108,9 +161,10 @@ namespace splashkit_lib
             notify_of_free(effect);
 
             _sound_effects.erase(effect->name);
+            untrack_resource_memory(SOUND_RESOURCE, effect);
             sk_close_sound_data(&effect->effect);
             effect->id = NONE_PTR;  // ensure future use of this pointer will fail...
-            delete(effect);
+            delete_resource(effect);
         }
         else
         {
@@ -144,6 +198,8 @@ namespace splashkit_lib
         if (volume < 0) volume = 0;
         else if (volume > 1) volume = 1;
 
+        if ( ! _use_sound_effect(effect) ) return;
+
         // play the effect, seaching for a channel
         sk_play_sound(&effect->effect, loops, volume);
     }
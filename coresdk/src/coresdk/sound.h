@@ -9,7 +9,10 @@
 #define sound_h
 
 #include <string>
+#include <vector>
+#include <cstdint>
 using std::string;
+using std::vector;
 
 namespace splashkit_lib
 {
@@ -60,6 +63,20 @@ namespace splashkit_lib
      */
     sound_effect load_sound_effect(const string &name, const string &filename);
 
+    /**
+     * @brief Loads and returns a sound effect from audio data already in memory.
+     *
+     * The data is the contents of a sound file (wav, ogg, etc.), such as
+     * data received over the network. The supplied `name` indicates the name
+     * to use to refer to this `sound_effect`.
+     *
+     * @param name      The name used to refer to the sound effect.
+     * @param data      The contents of the sound file.
+     *
+     * @returns A new `sound_effect`, or nullptr if the data could not be decoded.
+     */
+    sound_effect load_sound_effect_from_memory(const string &name, const vector<int8_t> &data);
+
     /**
      * Determines if SplashKit has a sound effect loaded for the supplied name.
      * This checks against all sounds loaded, those loaded without a name
@@ -20,9 +20,11 @@
 
 #include <cmath>
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 using std::map;
+using std::unordered_map;
 using std::vector;
 using std::to_string;
 using std::swap;
@@ -32,7 +34,10 @@ namespace splashkit_lib
     timer _sprite_timer = nullptr;
     vector<sprite_event_handler *> _global_sprite_event_handlers;
 
-    map<string, sprite> _sprites;
+    unordered_map<string, sprite> _sprites;
+
+    // The next number to try when making a unique name from each sprite name
+    static unordered_map<string, int> _sprite_name_counters;
 
     // Sprite pack data
 #define INITIAL_PACK_NAME "default"
@@ -165,21 +170,11 @@ namespace splashkit_lib
 
     sprite create_sprite(const string &name, bitmap layer, animation_script ani)
     {
-        string sn;
-        int idx;
-
         // Find a unique name for this sprite
-        idx = 0;
-        sn = name;
-
-        while (has_sprite(sn))
-        {
-            sn = name + to_string(idx);
-            idx += 1;
-        }
+        string sn = unique_name(_sprites, _sprite_name_counters, name);
 
         //allocate the space for the sprite
-        sprite result = new _sprite_data();
+        sprite result = new_resource<_sprite_data>();
 
         result->id = SPRITE_PTR;
         result->name = sn;
@@ -231,7 +226,7 @@ namespace splashkit_lib
         result->last_update = timer_ticks(_sprite_timer);
 
         // Write_ln("adding for ", name, " ", Hex_str(obj));
-        _sprites[name] = result;
+        _sprites[sn] = result;
 
         current_pack().push_back(result);
 
@@ -283,12 +278,13 @@ namespace splashkit_lib
         _sprites.erase(s->name);
 
         s->id = NONE_PTR;
-        delete s;
+        delete_resource(s);
     }
 
     void free_all_sprites()
     {
         FREE_ALL_FROM_MAP(_sprites, SPRITE_PTR, free_sprite);
+        _sprite_name_counters.clear();
     }
 
     //-----------------------------------------------------------------------------
@@ -17,9 +17,31 @@
 #include <cstdio>
 
 #include <map>
+#include <unordered_map>
 namespace splashkit_lib
 {
-    static map<string, font> _fonts;
+    static std::unordered_map<string, font> _fonts;
+
+    // Estimates the memory used by the open sizes of the font
+    static size_t _font_memory(font fnt)
+    {
+        return static_cast<size_t>(fnt->_file_size) * fnt->_data.size();
+    }
+
+    /**
+     * Closes all but one of the font's sizes. The kept size is counted again
+     * when the font is next used.
+     */
+    static bool _evict_font_sizes(void *resource)
+    {
+        return sk_trim_font_sizes(static_cast<font>(resource));
+    }
+
+    // Records the use of the font, and any sizes opened to draw or measure text
+    static void _use_font(font fnt)
+    {
+        if ( fnt ) track_resource_memory(FONT_RESOURCE, fnt, _font_memory(fnt), _evict_font_sizes);
+    }
 
     bool has_font(font fnt)
     {
@@ -56,6 +78,7 @@ namespace splashkit_lib
         if (has_font(fnt))
         {
             sk_add_font_size(fnt, font_size);
+            _use_font(fnt);
         }
         else
         {
@@ -76,9 +99,7 @@ namespace splashkit_lib
         }
         else
         {
-            string filename = path_to_resource(name, FONT_RESOURCE);
-
-            if ( file_exists(filename) or file_exists(name))
+            if ( has_resource_file(name, FONT_RESOURCE) )
                 return load_font(name, name);
             return nullptr;
         }
@@ -95,9 +116,10 @@ namespace splashkit_lib
                 remove(fnt->filename.c_str());
             }
             _fonts.erase(fnt->name);
+            untrack_resource_memory(FONT_RESOURCE, fnt);
             sk_close_font(fnt);
             fnt->id = NONE_PTR;  // ensure future use of this pointer will fail...
-            delete(fnt);
+            delete_resource(fnt);
         }
         else
         {
@@ -164,47 +186,63 @@ namespace splashkit_lib
         return get_font_style(font_named(name));
     }
 
+    /**
+     * Registers the newly loaded font with the given name, or cleans it up if it failed to load.
+     */
+    font _register_loaded_font(const string &name, const string &file_path, font result)
+    {
+        if (!sk_contains_valid_font(result))
+        {
+            delete_resource(result);
+            result = nullptr;
+            LOG(WARNING) << "LoadFont failed: " + name + " (" + file_path + ")";
+        } else
+        {
+            _fonts[name] = result;
+            result->name = name; // Need to clean this up, name is set to filename in sk_load_font
+            _use_font(result);
+        }
+
+        return result;
+    }
+
     font load_font(const string &name, const string &filename)
     {
         if (has_font(name)) return font_named(name);
 
-        string file_path = filename;
+        string file_path = find_resource_file(filename, FONT_RESOURCE);
 
-        if ( ! file_exists(file_path) )
+        if ( file_path.empty() )
         {
-            file_path = path_to_resource(filename, FONT_RESOURCE);
+            file_path = resource_file_path(filename + ".ttf", FONT_RESOURCE);
 
-            if ( ! file_exists(file_path) )
+            if ( file_path.empty() )
             {
-                file_path = path_to_resource(filename + ".ttf", FONT_RESOURCE);
-
+                file_path = sk_find_system_font_path(filename);
+                // LOG(TRACE) << "Loading font: " << file_path;
                 if ( ! file_exists(file_path) )
                 {
-                    file_path = sk_find_system_font_path(filename);
-                    // LOG(TRACE) << "Loading font: " << file_path;
-                    if ( ! file_exists(file_path) )
-                    {
-						LOG(WARNING) << cat({ "Unable to locate font file for ", name, " (", filename, ")"});
-                        return nullptr;
-                    }
+                    LOG(WARNING) << cat({ "Unable to locate font file for ", name, " (", filename, ")"});
+                    return nullptr;
                 }
             }
         }
 
         font result = sk_load_font(file_path.c_str(), 64);
 
-        if (!sk_contains_valid_font(result))
-        {
-            delete result;
-            result = nullptr;
-            LOG(WARNING) << "LoadFont failed: " + name + " (" + file_path + ")";
-        } else
-        {
-            _fonts[name] = result;
-            result->name = name; // Need to clean this up, name is set to filename in sk_load_font
-        }
+        return _register_loaded_font(name, file_path, result);
+    }
 
-        return result;
+    font load_font_from_memory(const string &name, const char *data, unsigned long size)
+    {
+        if (has_font(name)) return font_named(name);
+
+        return _register_loaded_font(name, "memory", sk_load_font_from_memory(data, size, 64));
+    }
+
+    font load_font_from_memory(const string &name, const vector<int8_t> &data)
+    {
+        return load_font_from_memory(name, reinterpret_cast<const char *>(data.data()), data.size());
     }
 
     void draw_text(const string &text, const color &clr, font fnt, int font_size, double x, double y, const drawing_options &opts)
@@ -220,6 +258,7 @@ namespace splashkit_lib
         xy_from_opts(opts, x, y);
 
         sk_draw_text(to_surface_ptr(opts.dest), fnt, font_size, x, y, text.c_str(), clr);
+        _use_font(fnt);
     }
 
     void draw_text(const string &text, const color &clr, font fnt, int font_size, double x, double y)
@@ -317,6 +356,7 @@ namespace splashkit_lib
 
         int w = 0, h = 0;
         sk_text_size(fnt, font_size, text.c_str(), &w, &h);
+        _use_font(fnt);
         return w;
     }
 
@@ -335,6 +375,7 @@ namespace splashkit_lib
 
         int w = 0, h = 0;
         sk_text_size(fnt, font_size, text.c_str(), &w, &h);
+        _use_font(fnt);
         return h;
     }
 
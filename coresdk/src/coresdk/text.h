@@ -15,7 +15,10 @@
 #include "drawing_options.h"
 
 #include <string>
+#include <vector>
+#include <cstdint>
 using std::string;
+using std::vector;
 
 namespace splashkit_lib
 {
@@ -90,6 +93,20 @@ namespace splashkit_lib
      */
     font load_font(const string &name, const string &filename);
 
+    /**
+     * @brief Loads a new font from font data already in memory.
+     *
+     * The data is the contents of a font file (ttf), such as data received
+     * over the network. A copy is kept so that the font can be drawn at
+     * different sizes.
+     *
+     * @param name          The name of the `font` to be loaded.
+     * @param data          The contents of the font file.
+     *
+     * @returns Returns a new `font` object.
+     */
+    font load_font_from_memory(const string &name, const vector<int8_t> &data);
+
     /**
      * @brief Frees a loaded font.
      *
@@ -13,12 +13,14 @@
 #include "utility_functions.h"
 
 #include <map>
+#include <unordered_map>
 
 using std::map;
+using std::unordered_map;
 
 namespace splashkit_lib
 {
-    static map<string, timer> _timers;
+    static unordered_map<string, timer> _timers;
 
     struct _timer_data
     {
@@ -35,7 +37,7 @@ namespace splashkit_lib
         if (has_timer(name)) return timer_named(name);
 
         timer result;
-        result = new(_timer_data);
+        result = new_resource<_timer_data>();
         result->id = TIMER_PTR;
         result->name = name;
 
@@ -68,7 +70,7 @@ namespace splashkit_lib
 
         to_free->id = NONE_PTR;
 
-        delete(to_free);
+        delete_resource(to_free);
     }
 
     void free_all_timers()
@@ -283,6 +283,7 @@ namespace splashkit_lib
      * @constant HTTP_STATUS_MOVED_PERMANENTLY          The URL of the requested resource has been changed permanently.
      * @constant HTTP_STATUS_FOUND                      The URI of requested resource has been changed temporarily.
      * @constant HTTP_STATUS_SEE_OTHER                  The server sent this response to direct the client to get the requested resource at another URI with a GET request.
+     * @constant HTTP_STATUS_NOT_MODIFIED               The resource has not changed since the version the client already has.
      * @constant HTTP_STATUS_BAD_REQUEST                The server cannot or will not process the request due to an apparent client error.
      * @constant HTTP_STATUS_UNAUTHORIZED               The server requires authentication or has failed to process provided authentication.
      * @constant HTTP_STATUS_FORBIDDEN                  The request was a valid request, but the server is refusing to respond to it.
@@ -302,6 +303,7 @@ namespace splashkit_lib
         HTTP_STATUS_MOVED_PERMANENTLY = 301,
         HTTP_STATUS_FOUND = 302,
         HTTP_STATUS_SEE_OTHER = 303,
+        HTTP_STATUS_NOT_MODIFIED = 304,
         HTTP_STATUS_BAD_REQUEST = 400,
         HTTP_STATUS_UNAUTHORIZED = 401,
         HTTP_STATUS_FORBIDDEN = 403,
@@ -313,5 +315,25 @@ namespace splashkit_lib
         HTTP_STATUS_NOT_IMPLEMENTED = 501,
         HTTP_STATUS_SERVICE_UNAVAILABLE = 503
     };
+
+    /**
+     * The format used when converting `json` objects to and from bytes or
+     * files. The binary formats are smaller and faster to read than text.
+     *
+     * @constant JSON_TEXT          Indented JSON text, easy to read and edit.
+     * @constant JSON_COMPACT_TEXT  JSON text without any whitespace.
+     * @constant JSON_MESSAGEPACK   The MessagePack binary format.
+     * @constant JSON_CBOR          The CBOR binary format.
+     * @constant JSON_BSON          The BSON binary format. Only objects can
+     *                              be stored in this format.
+     */
+    enum json_format
+    {
+        JSON_TEXT,
+        JSON_COMPACT_TEXT,
+        JSON_MESSAGEPACK,
+        JSON_CBOR,
+        JSON_BSON
+    };
 }
 #endif /* types_hpp */
@@ -8,6 +8,7 @@
 
 #include "web_client.h"
 #include "web_driver.h"
+#include "core_driver.h"
 #include "utility_functions.h"
 #include <fstream>
 #include <cstdio>
@@ -22,6 +23,8 @@ using std::ios;
 
 #ifdef WINDOWS
 #include <Windows.h>
+#else
+#include <unistd.h>
 #endif
 namespace splashkit_lib
 {
@@ -46,6 +49,30 @@ namespace splashkit_lib
         return make_request(HTTP_GET_METHOD, url, port, "", {});
     }
 
+    http_response http_get_to_file(const string &url, unsigned short port, const string &filename)
+    {
+        internal_sk_init();
+
+        FILE *file = fopen(filename.c_str(), "wb");
+        if ( not file )
+        {
+            LOG(WARNING) << "Unable to open " << filename << " to save the response from " << url;
+            return nullptr;
+        }
+
+        http_response result = sk_http_get_to_file(url, port, file);
+        fclose(file);
+
+        return result;
+    }
+
+    http_response http_get_streamed(const string &url, unsigned short port, http_data_callback *on_data)
+    {
+        internal_sk_init();
+
+        return sk_http_get_streamed(url, port, on_data);
+    }
+
     http_response http_post(const string &url, unsigned short port, const string &body, const vector<string> &headers)
     {
         return make_request(HTTP_POST_METHOD, url, port, body, headers);
@@ -56,6 +83,101 @@ namespace splashkit_lib
         return http_post(url, port, body, {});
     }
 
+    pending_request make_request_async(http_method request_type, const string &uri, unsigned short port, const string &body, const vector<string> &headers, http_response_callback *on_complete)
+    {
+        sk_pending_request *request = new sk_pending_request;
+
+        request->id = PENDING_REQUEST_PTR;
+        request->method = request_type;
+        request->uri = uri;
+        request->port = port;
+        request->body = body;
+        request->headers = headers;
+        request->on_complete = on_complete;
+
+        sk_http_make_request_async(request);
+
+        return request;
+    }
+
+    pending_request http_get_async(const string &url, unsigned short port)
+    {
+        return make_request_async(HTTP_GET_METHOD, url, port, "", {}, nullptr);
+    }
+
+    pending_request http_get_async(const string &url, unsigned short port, http_response_callback *on_complete)
+    {
+        return make_request_async(HTTP_GET_METHOD, url, port, "", {}, on_complete);
+    }
+
+    pending_request http_post_async(const string &url, unsigned short port, const string &body, const vector<string> &headers)
+    {
+        return make_request_async(HTTP_POST_METHOD, url, port, body, headers, nullptr);
+    }
+
+    pending_request http_post_async(const string &url, unsigned short port, const string &body, const vector<string> &headers, http_response_callback *on_complete)
+    {
+        return make_request_async(HTTP_POST_METHOD, url, port, body, headers, on_complete);
+    }
+
+    bool request_ready(pending_request request)
+    {
+        if ( INVALID_PTR(request, PENDING_REQUEST_PTR) )
+        {
+            LOG(WARNING) << "Checking request_ready on an invalid pending request";
+            return false;
+        }
+
+        lock_guard<mutex> lock(request->lock);
+        return request->complete;
+    }
+
+    http_response request_result(pending_request request)
+    {
+        if ( INVALID_PTR(request, PENDING_REQUEST_PTR) )
+        {
+            LOG(WARNING) << "Getting request_result of an invalid pending request";
+            return nullptr;
+        }
+
+        sk_wait_for_request(request);
+        return request->response;
+    }
+
+    void free_pending_request(pending_request request)
+    {
+        if ( INVALID_PTR(request, PENDING_REQUEST_PTR) )
+        {
+            LOG(WARNING) << "Attempting to free an invalid pending request";
+            return;
+        }
+
+        notify_of_free(request);
+        sk_release_pending_request(request);
+    }
+
+    void enable_http_cache(const string &directory)
+    {
+        enable_http_cache(directory, 64 * 1024 * 1024);
+    }
+
+    void enable_http_cache(const string &directory, unsigned int max_bytes)
+    {
+        internal_sk_init();
+
+        sk_enable_http_cache(directory, max_bytes);
+    }
+
+    void disable_http_cache()
+    {
+        sk_disable_http_cache();
+    }
+
+    void clear_http_cache()
+    {
+        sk_clear_http_cache();
+    }
+
     void save_response_to_file(http_response response, string filename)
     {
         ofstream file(filename, ios::binary);
@@ -76,26 +198,12 @@ namespace splashkit_lib
 
     bool download_file(const string &name, const string &url, unsigned short port, string &path)
     {
-        http_response response = http_get(url, port);
-
-        if ( !response )
-        {
-            return false;
-        }
-
-        auto cleanup_response = finally( [&] { free_response(response); });
-
-        if ( static_cast<int>(response->code) < 200 || static_cast<int>(response->code) >= 300 )
-        {
-            LOG(WARNING) << "Unable to download file from " << url << " got status " << response->code;
-            return false;
-        }
-
         char *tmpname;
 
 #ifndef WINDOWS
         tmpname = strdup("/tmp/splashkit.file.XXXXXX");
-        mkstemp(tmpname);
+        int fd = mkstemp(tmpname);
+        if ( fd != -1 ) close(fd);
 #else
         char fname[L_tmpnam];
         tmpnam (fname);
@@ -107,65 +215,92 @@ namespace splashkit_lib
         tmpname = strdup(fpath.c_str());
         LOG(WARNING) << tmpname;
 #endif
-        save_response_to_file(response, tmpname);
-
         path = string(tmpname);
         free(tmpname);
 
+        // Stream the body straight to disk, rather than buffering it first
+        http_response response = http_get_to_file(url, port, path);
+
+        if ( !response )
+        {
+            remove(path.c_str());
+            return false;
+        }
+
+        auto cleanup_response = finally( [&] { free_response(response); });
+
+        if ( static_cast<int>(response->code) < 200 || static_cast<int>(response->code) >= 300 )
+        {
+            LOG(WARNING) << "Unable to download file from " << url << " got status " << response->code;
+            remove(path.c_str());
+            return false;
+        }
+
         return true;
     }
 
-    bitmap download_bitmap(const string &name, const string &url, unsigned short port)
+    /**
+     * Gets the resource at the url, returning the response only if it
+     * was successful. The caller must free the response.
+     */
+    http_response _download_to_memory(const string &url, unsigned short port)
     {
-        string path;
-        if ( not download_file(name, url, port, path) )
+        http_response response = http_get(url, port);
+
+        if ( !response )
         {
             return nullptr;
         }
 
-        bitmap result = load_bitmap(name, path);
-        remove(path.c_str()); // Delete the file
-        return result;
+        if ( static_cast<int>(response->code) < 200 || static_cast<int>(response->code) >= 300 )
+        {
+            LOG(WARNING) << "Unable to download file from " << url << " got status " << response->code;
+            free_response(response);
+            return nullptr;
+        }
+
+        return response;
+    }
+
+    bitmap download_bitmap(const string &name, const string &url, unsigned short port)
+    {
+        http_response response = _download_to_memory(url, port);
+        if ( not response ) return nullptr;
+
+        auto cleanup_response = finally( [&] { free_response(response); });
+
+        // decode straight from the response body, without writing it to disk
+        return load_bitmap_from_memory(name, response->message, response->message_size);
     }
 
     font download_font(const string &name, const string &url, unsigned short port)
     {
-        string path;
-        if ( not download_file(name, url, port, path) )
-        {
-            return nullptr;
-        }
+        http_response response = _download_to_memory(url, port);
+        if ( not response ) return nullptr;
 
-        font result = load_font(name, path);
-        if ( VALID_PTR(result, FONT_PTR) )
-            result->was_downloaded = true; // ensure that font will delete file when it is released.
-        return result;
+        auto cleanup_response = finally( [&] { free_response(response); });
+
+        return load_font_from_memory(name, response->message, response->message_size);
     }
 
     sound_effect download_sound_effect(const string &name, const string &url, unsigned short port)
     {
-        string path;
-        if ( not download_file(name, url, port, path) )
-        {
-            return nullptr;
-        }
+        http_response response = _download_to_memory(url, port);
+        if ( not response ) return nullptr;
 
-        sound_effect result = load_sound_effect(name, path);
-        remove(path.c_str()); // Delete the file
-        return result;
+        auto cleanup_response = finally( [&] { free_response(response); });
+
+        return load_sound_effect_from_memory(name, response->message, response->message_size);
     }
 
     music download_music(const string &name, const string &url, unsigned short port)
     {
-        string path;
-        if ( not download_file(name, url, port, path) )
-        {
-            return nullptr;
-        }
+        http_response response = _download_to_memory(url, port);
+        if ( not response ) return nullptr;
 
-        music result = load_music(name, path);
-        remove(path.c_str()); // Delete the file
-        return result;
+        auto cleanup_response = finally( [&] { free_response(response); });
+
+        return load_music_from_memory(name, response->message, response->message_size);
     }
 
     void free_response (http_response response)
@@ -27,6 +27,33 @@ namespace splashkit_lib
      */
     typedef struct sk_http_response *http_response;
 
+    /**
+     * A pending request is a HTTP request that is being made in the background.
+     * Check `request_ready` to see when it has finished, then use
+     * `request_result` to access the response. Once you are done with it,
+     * call `free_pending_request`.
+     *
+     * @attribute class pending_request
+     */
+    typedef struct sk_pending_request *pending_request;
+
+    /**
+     * The http response callback is called from `process_events` when a
+     * pending request finishes.
+     *
+     * @param request The request that has finished.
+     */
+    typedef void (http_response_callback)(pending_request request);
+
+    /**
+     * The http data callback is called with each chunk of a response body as
+     * it is received, allowing large downloads to be processed without
+     * holding the whole body in memory.
+     *
+     * @param data  The next chunk of the response body.
+     */
+    typedef void (http_data_callback)(const string &data);
+
     /**
      * Make a get request to access a resource on the internet.
      *
@@ -59,6 +86,116 @@ namespace splashkit_lib
      */
     http_response http_post(const string &url, unsigned short port, const string &body, const vector<string> &headers);
 
+    /**
+     * Make a get request, writing the body of the response straight into a
+     * file as it is received. The returned response contains the status and
+     * content type, but its body is empty.
+     *
+     * @param  url      The path to the resource, for example http://splashkit.io
+     * @param  port     The port on the server (80 for http, 443 for https)
+     * @param  filename The path to the file to write the body to
+     * @return          The response from the server, or nullptr if it failed
+     */
+    http_response http_get_to_file(const string &url, unsigned short port, const string &filename);
+
+    /**
+     * Make a get request, passing each chunk of the response body to the
+     * callback as it is received. The returned response contains the status
+     * and content type, but its body is empty.
+     *
+     * @param  url      The path to the resource, for example http://splashkit.io
+     * @param  port     The port on the server (80 for http, 443 for https)
+     * @param  on_data  The function to call with each chunk of the body
+     * @return          The response from the server, or nullptr if it failed
+     */
+    http_response http_get_streamed(const string &url, unsigned short port, http_data_callback *on_data);
+
+    /**
+     * Start a get request in the background. The game loop keeps running while
+     * the request is made, use `request_ready` to check when the response has
+     * arrived.
+     *
+     * @param  url  The path to the resource, for example http://splashkit.io
+     * @param  port The port on the server (80 for http, 443 for https)
+     * @return      The pending request
+     */
+    pending_request http_get_async(const string &url, unsigned short port);
+
+    /**
+     * Start a get request in the background, and have the callback called
+     * from `process_events` once the response arrives.
+     *
+     * @param  url          The path to the resource, for example http://splashkit.io
+     * @param  port         The port on the server (80 for http, 443 for https)
+     * @param  on_complete  The function to call when the request has finished
+     * @return              The pending request
+     *
+     * @attribute suffix  with_callback
+     */
+    pending_request http_get_async(const string &url, unsigned short port, http_response_callback *on_complete);
+
+    /**
+     * Start a post request in the background, with the given headers.
+     *
+     * @param  url      The url of the server to post the data to
+     * @param  port     The port to connect to on the server
+     * @param  body     The body of the message to post
+     * @param  headers  The headers of the request
+     * @return          The pending request
+     */
+    pending_request http_post_async(const string &url, unsigned short port, const string &body, const vector<string> &headers);
+
+    /**
+     * Start a post request in the background, with the given headers, and have
+     * the callback called from `process_events` once the response arrives.
+     *
+     * @param  url          The url of the server to post the data to
+     * @param  port         The port to connect to on the server
+     * @param  body         The body of the message to post
+     * @param  headers      The headers of the request
+     * @param  on_complete  The function to call when the request has finished
+     * @return              The pending request
+     *
+     * @attribute suffix  with_callback
+     */
+    pending_request http_post_async(const string &url, unsigned short port, const string &body, const vector<string> &headers, http_response_callback *on_complete);
+
+    /**
+     * Checks if a pending request has finished.
+     *
+     * @param  request  The pending request to check
+     * @return          True when the response (or failure) has arrived
+     *
+     * @attribute class pending_request
+     * @attribute getter is_ready
+     */
+    bool request_ready(pending_request request);
+
+    /**
+     * Returns the response to a pending request, waiting for it to finish if
+     * it is not yet ready. The response is nullptr if the request failed.
+     * The response is freed along with the pending request.
+     *
+     * @param  request  The pending request
+     * @return          The response from the server
+     *
+     * @attribute class pending_request
+     * @attribute getter result
+     */
+    http_response request_result(pending_request request);
+
+    /**
+     * Free the pending request, and its response. If the request is still in
+     * progress it is released once it finishes.
+     *
+     * @param request The pending request to free
+     *
+     * @attribute class pending_request
+     * @attribute destructor true
+     * @attribute method free
+     */
+    void free_pending_request(pending_request request);
+
     /**
      * Download an image from a web server and load it into SplashKit so that
      * you can use it.
@@ -103,6 +240,40 @@ namespace splashkit_lib
      */
     music download_music(const string &name, const string &url, unsigned short port);
 
+    /**
+     * Keep the bodies of get requests, and the resources downloaded, in a
+     * cache directory. Fresh entries are read from disk without contacting
+     * the server, and stale ones are checked with the server so unchanged
+     * resources are not downloaded again. The cache is limited to 64MB,
+     * removing the least recently used entries when it is full.
+     *
+     * @param directory The directory to store the cached responses in
+     */
+    void enable_http_cache(const string &directory);
+
+    /**
+     * Keep the bodies of get requests, and the resources downloaded, in a
+     * cache directory of at most `max_bytes`, removing the least recently
+     * used entries when it is full.
+     *
+     * @param directory The directory to store the cached responses in
+     * @param max_bytes The maximum size of the cached bodies
+     *
+     * @attribute suffix  with_limit
+     */
+    void enable_http_cache(const string &directory, unsigned int max_bytes);
+
+    /**
+     * Stop using the http cache. The files are left in the cache directory,
+     * and will be reused if the cache is enabled again.
+     */
+    void disable_http_cache();
+
+    /**
+     * Remove all of the responses stored in the http cache.
+     */
+    void clear_http_cache();
+
     /**
      * Read the HTTP response and convert it to text
      *
@@ -192,8 +192,19 @@ namespace splashkit_lib
         return r->query_string;
     }
 
-// From: https://cboard.cprogramming.com/c-programming/13752-how-parse-query_string.html
-#define TO_HEX(Y) (Y>='0'&&Y<='9'?Y-'0':Y-'A'+10)
+    /*
+     * Finds the first decoded parameter with the given name, or nullptr
+     * if the query string did not include it.
+     */
+    static const string *_find_query_parameter(http_request r, const string &name)
+    {
+        for (const auto &param : r->query_parameters)
+        {
+            if ( param.first == name ) return &param.second;
+        }
+
+        return nullptr;
+    }
 
     string request_query_parameter(http_request r, const string &name, const string &default_value)
     {
@@ -203,53 +214,42 @@ namespace splashkit_lib
             return "";
         }
 
-        string query_string = r->query_string;
-
-        size_t idx = query_string.find(name + "=");
+        const string *value = _find_query_parameter(r, name);
 
-        if ( idx == string::npos) return default_value;
+        if ( not value ) return default_value;
 
-        auto iter = query_string.begin() + idx + name.length() + 1;
-        stringstream result;
+        return *value;
+    }
 
-        while ( iter < query_string.end() )
+    bool request_has_query_parameter(http_request r, const string &name)
+    {
+        if (INVALID_PTR(r, HTTP_REQUEST_PTR))
         {
-            if ( *iter == '%' )
-            {
-                result << (char)((TO_HEX(*(iter + 1)) << 4) + TO_HEX(*(iter + 2)));
-                iter += 2;
-            }
-            else if ( *iter == '+' )
-            {
-                result << ' ';
-            }
-            else if ( *iter == '&' )
-            {
-                break; // end of parameter
-            }
-            else
-            {
-                result << *iter;
-            }
-
-            iter++;
+            LOG(WARNING) << "Getting query parameter with invalid request";
+            return false;
         }
 
-        return result.str();
+        return _find_query_parameter(r, name) != nullptr;
     }
 
-    bool request_has_query_parameter(http_request r, const string &name)
+    json request_query_parameters(http_request r)
     {
+        json result = create_json();
+
         if (INVALID_PTR(r, HTTP_REQUEST_PTR))
         {
-            LOG(WARNING) << "Getting query parameter with invalid request";
-            return "";
+            LOG(WARNING) << "Getting query parameters with invalid request";
+            return result;
         }
 
-        return r->query_string.find(name + "=") != string::npos;
-    }
+        for (const auto &param : r->query_parameters)
+        {
+            if ( not json_has_key(result, param.first) )
+                json_set_string(result, param.first, param.second);
+        }
 
-#undef TO_HEX
+        return result;
+    }
 
     http_method request_method(http_request r)
     {
@@ -345,4 +345,152 @@ namespace splashkit_lib
     {
         return is_request_for(request, HTTP_TRACE_METHOD, path);
     }
+
+    void web_server_websocket(web_server server, const string &path)
+    {
+        if (INVALID_PTR(server, WEB_SERVER_PTR))
+        {
+            LOG(WARNING) << "web_server_websocket called on an invalid server";
+            return;
+        }
+
+        sk_add_websocket_endpoint(server, path);
+    }
+
+    bool has_new_websockets(web_server server)
+    {
+        if (INVALID_PTR(server, WEB_SERVER_PTR))
+        {
+            LOG(WARNING) << "has_new_websockets called on an invalid server";
+            return false;
+        }
+
+        sk_collect_websocket_events(server);
+        return server->new_websockets.size() > 0;
+    }
+
+    websocket fetch_new_websocket(web_server server)
+    {
+        if (not has_new_websockets(server)) return nullptr;
+
+        websocket result = server->new_websockets.front();
+        server->new_websockets.erase(server->new_websockets.begin());
+        return result;
+    }
+
+    string websocket_path(websocket ws)
+    {
+        if (INVALID_PTR(ws, WEBSOCKET_PTR))
+        {
+            LOG(WARNING) << "Getting websocket path with invalid websocket";
+            return "";
+        }
+
+        return ws->endpoint->path;
+    }
+
+    bool is_websocket_open(websocket ws)
+    {
+        if (INVALID_PTR(ws, WEBSOCKET_PTR))
+        {
+            return false;
+        }
+
+        lock_guard<mutex> lock(ws->lock);
+        return ws->open;
+    }
+
+    bool websocket_send(websocket ws, const string &a_msg)
+    {
+        if (INVALID_PTR(ws, WEBSOCKET_PTR))
+        {
+            LOG(WARNING) << "websocket_send called on an invalid websocket";
+            return false;
+        }
+
+        return sk_websocket_send(ws, a_msg);
+    }
+
+    void websocket_broadcast(web_server server, const string &path, const string &a_msg)
+    {
+        if (INVALID_PTR(server, WEB_SERVER_PTR))
+        {
+            LOG(WARNING) << "websocket_broadcast called on an invalid server";
+            return;
+        }
+
+        if ( path.empty() ) return;
+
+        sk_websocket_broadcast(server, path, a_msg);
+    }
+
+    void websocket_broadcast(web_server server, const string &a_msg)
+    {
+        if (INVALID_PTR(server, WEB_SERVER_PTR))
+        {
+            LOG(WARNING) << "websocket_broadcast called on an invalid server";
+            return;
+        }
+
+        sk_websocket_broadcast(server, "", a_msg);
+    }
+
+    void close_websocket(websocket ws)
+    {
+        if (INVALID_PTR(ws, WEBSOCKET_PTR))
+        {
+            LOG(WARNING) << "close_websocket called on an invalid websocket";
+            return;
+        }
+
+        sk_close_websocket(ws);
+    }
+
+    bool has_websocket_messages(web_server server)
+    {
+        return websocket_message_count(server) > 0;
+    }
+
+    unsigned int websocket_message_count(web_server server)
+    {
+        if (INVALID_PTR(server, WEB_SERVER_PTR))
+        {
+            LOG(WARNING) << "websocket_message_count called on an invalid server";
+            return 0;
+        }
+
+        sk_collect_websocket_events(server);
+        return server->websocket_messages.size();
+    }
+
+    message read_websocket_message(web_server server)
+    {
+        if (not has_websocket_messages(server)) return nullptr;
+
+        message result = server->websocket_messages.front();
+        server->websocket_messages.erase(server->websocket_messages.begin());
+        sk_websocket_message_read(result);
+        return result;
+    }
+
+    string read_websocket_message_data(web_server server)
+    {
+        message msg = read_websocket_message(server);
+        if (not msg) return "";
+
+        string result = message_data(msg);
+        close_message(msg);
+        return result;
+    }
+
+    websocket message_websocket(message msg)
+    {
+        if (INVALID_PTR(msg, MESSAGE_PTR))
+        {
+            LOG(WARNING) << "Getting websocket for invalid message";
+            return nullptr;
+        }
+
+        return msg->websocket;
+    }
 }
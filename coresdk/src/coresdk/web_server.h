@@ -10,6 +10,7 @@
 
 #include "types.h"
 #include "json.h"
+#include "networking.h"
 
 #include <string>
 #include <vector>
@@ -34,6 +35,15 @@ namespace splashkit_lib
      */
     typedef struct sk_http_request *http_request;
 
+    /**
+     * A websocket is a connection a client has upgraded to a WebSocket on one
+     * of the server's websocket paths. Unlike a `http_request`, it stays open
+     * so the server can push messages to the client whenever it needs to.
+     *
+     * @attribute class websocket
+     */
+    typedef struct sk_websocket_data *websocket;
+
     /**
      * The method token is used to indicate the kind of action to be performed
      * on the server. See [W3 specifications](https://www.w3.org/Protocols/rfc2616/rfc2616-sec5.html).
@@ -315,6 +325,22 @@ namespace splashkit_lib
      */
     bool request_has_query_parameter(http_request r, const string &name);
 
+    /**
+     * Returns all of the parameters from within the query string. Each parameter
+     * name is a key in the resulting json object, with its decoded value stored
+     * as a string. When a parameter is repeated, the first value is used.
+     *
+     * The returned json object must be freed with `free_json`.
+     *
+     * @param r A request object.
+     *
+     * @returns A json object containing the parameters from the query string.
+     *
+     * @attribute class http_request
+     * @attribute getter query_parameters
+     */
+    json request_query_parameters(http_request r);
+
     /**
      * Returns the HTTP method of the client request.
      *
@@ -468,5 +494,192 @@ namespace splashkit_lib
      * @attribute method is_trace_request_for
      */
     bool is_trace_request_for(http_request request, const string &path);
+
+    /**
+     * Allows clients to open WebSocket connections to the server at the
+     * given path. New connections can be fetched with `fetch_new_websocket`,
+     * and the messages they send are read with `read_websocket_message`.
+     *
+     * @param server  The `web_server` to accept websockets on.
+     * @param path    The path clients will connect to, such as "/updates".
+     *
+     * @attribute class web_server
+     * @attribute self  server
+     * @attribute method add_websocket
+     */
+    void web_server_websocket(web_server server, const string &path);
+
+    /**
+     * Checks if clients have opened any websockets on the server that have not
+     * yet been fetched.
+     *
+     * @param server  The `web_server` to check.
+     *
+     * @returns True if there are new websockets waiting to be fetched.
+     *
+     * @attribute class web_server
+     * @attribute self  server
+     * @attribute getter has_new_websockets
+     */
+    bool has_new_websockets(web_server server);
+
+    /**
+     * Returns the next websocket that has been opened on the server, or
+     * nullptr if there are no new websockets.
+     *
+     * @param server  The `web_server` to get the websocket from.
+     *
+     * @returns The next new websocket.
+     *
+     * @attribute class web_server
+     * @attribute self  server
+     * @attribute method fetch_new_websocket
+     */
+    websocket fetch_new_websocket(web_server server);
+
+    /**
+     * Returns the path the websocket was opened on.
+     *
+     * @param ws  The websocket.
+     *
+     * @returns The websocket path registered with `web_server_websocket`.
+     *
+     * @attribute class websocket
+     * @attribute getter path
+     */
+    string websocket_path(websocket ws);
+
+    /**
+     * Checks if the websocket is still open. Websockets are closed when the
+     * client disconnects, or when the server is stopped.
+     *
+     * @param ws  The websocket to check.
+     *
+     * @returns True if messages can still be sent on the websocket.
+     *
+     * @attribute class websocket
+     * @attribute getter is_open
+     */
+    bool is_websocket_open(websocket ws);
+
+    /**
+     * Sends a text message to the client on the other end of the websocket.
+     *
+     * @param ws      The websocket to send the message on.
+     * @param a_msg   The message to send.
+     *
+     * @returns True if the message was sent.
+     *
+     * @attribute class websocket
+     * @attribute method send
+     */
+    bool websocket_send(websocket ws, const string &a_msg);
+
+    /**
+     * Sends a text message to every open websocket on the given path.
+     *
+     * @param server  The `web_server` the websockets are connected to.
+     * @param path    The websocket path to send to.
+     * @param a_msg   The message to send.
+     *
+     * @attribute class web_server
+     * @attribute self  server
+     * @attribute method websocket_broadcast
+     *
+     * @attribute suffix  to_path
+     */
+    void websocket_broadcast(web_server server, const string &path, const string &a_msg);
+
+    /**
+     * Sends a text message to every open websocket on the server.
+     *
+     * @param server  The `web_server` the websockets are connected to.
+     * @param a_msg   The message to send.
+     *
+     * @attribute class web_server
+     * @attribute self  server
+     * @attribute method websocket_broadcast
+     */
+    void websocket_broadcast(web_server server, const string &a_msg);
+
+    /**
+     * Closes the websocket, and releases its resources. The websocket must
+     * not be used after it is closed.
+     *
+     * @param ws  The websocket to close.
+     *
+     * @attribute class websocket
+     * @attribute destructor true
+     * @attribute method close
+     */
+    void close_websocket(websocket ws);
+
+    /**
+     * Checks if any websocket messages are waiting to be read on the server.
+     *
+     * @param server  The `web_server` to check.
+     *
+     * @returns True if there are messages waiting to be read.
+     *
+     * @attribute class web_server
+     * @attribute self  server
+     * @attribute getter has_websocket_messages
+     */
+    bool has_websocket_messages(web_server server);
+
+    /**
+     * Returns the number of websocket messages waiting to be read on the server.
+     *
+     * @param server  The `web_server` to check.
+     *
+     * @returns The number of messages waiting to be read.
+     *
+     * @attribute class web_server
+     * @attribute self  server
+     * @attribute getter websocket_message_count
+     */
+    unsigned int websocket_message_count(web_server server);
+
+    /**
+     * Reads the first websocket message received by the server. Use
+     * `message_data` to read its contents, `message_websocket` to find
+     * the websocket it came from, and `close_message` when you are done
+     * with it.
+     *
+     * @param server  The `web_server` to read the message from.
+     *
+     * @returns The first message, or nullptr if there are no messages.
+     *
+     * @attribute class web_server
+     * @attribute self  server
+     * @attribute method read_websocket_message
+     */
+    message read_websocket_message(web_server server);
+
+    /**
+     * Reads the data of the first websocket message received by the server,
+     * and closes the message.
+     *
+     * @param server  The `web_server` to read the message from.
+     *
+     * @returns The data of the first message, or an empty string if there are no messages.
+     *
+     * @attribute class web_server
+     * @attribute self  server
+     * @attribute method read_websocket_message_data
+     */
+    string read_websocket_message_data(web_server server);
+
+    /**
+     * Returns the websocket a message was received on.
+     *
+     * @param msg The message to check.
+     *
+     * @returns The websocket the message came from, or nullptr if it was not a websocket message.
+     *
+     * @attribute class message
+     * @attribute getter websocket
+     */
+    websocket message_websocket(message msg);
 }
 #endif /* web_server_h_ */
@@ -108,6 +108,8 @@ namespace splashkit_lib
             return;
         }
 
+        use_bitmap(bmp);
+
         sk_set_icon(&wind->image.surface, &bmp->image.surface);
     }
     
@@ -14,6 +14,8 @@
 #include "images.h"
 #include "timers.h"
 #include "text.h"
+#include "input.h"
+#include "utils.h"
 
 #include <iostream>
 using namespace std;
@@ -24,6 +26,49 @@ void free_notification(void *resource)
     cout << "Freeing: " << hex << resource << dec << endl;
 }
 
+void print_packed_bundle(const string &heading)
+{
+    cout << heading << endl;
+    cout << "  Animation:   " << has_animation_script("WalkingScript") << endl;
+    cout << "  Bitmap:      " << has_bitmap("FrogBmp") << endl;
+    cout << "  Font:        " << has_font("hara") << endl;
+    cout << "  Sound:       " << has_sound_effect("error") << endl;
+    cout << "  Music:       " << has_music("background") << endl;
+    cout << "  Timer:       " << has_timer("my timer") << endl;
+    cout << "  Bundle:      " << has_resource_bundle("blah") << endl;
+    cout << "  Ufo:         " << has_bitmap("ufo") << endl;
+    cout << "  Bundle test: " << has_resource_bundle("packed") << endl;
+}
+
+// Packs the test bundle, then loads it back from the pack. Without compression every
+// entry is stored, while compressing deflates the text files and stores the images.
+void test_resource_packs()
+{
+    for (bool compress : { false, true })
+    {
+        string pack_file = compress ? "test_bundle_zlib.skpak" : "test_bundle_stored.skpak";
+
+        cout << "Packing " << pack_file << ": " << pack_resource_bundle("test.txt", pack_file, compress) << endl;
+
+        load_resource_bundle("packed", pack_file);
+        print_packed_bundle("After loading from the pack (all 1):");
+
+        if ( has_bitmap("FrogBmp") )
+            cout << "  Frog size:   " << bitmap_width("FrogBmp") << "x" << bitmap_height("FrogBmp") << endl;
+        free_resource_bundle("packed");
+
+        load_resource_bundle_async("packed", pack_file);
+        while ( bundle_load_progress("packed") < 1.0f )
+        {
+            process_events();
+        }
+        print_packed_bundle("After loading from the pack in the background (all 1):");
+        free_resource_bundle("packed");
+
+        print_packed_bundle("After freeing the packed bundle (all 0):");
+    }
+}
+
 void run_bundle_test()
 {
     register_free_notifier(&free_notification);
@@ -67,5 +112,47 @@ void run_bundle_test()
     cout << "  Bundle:      " << has_resource_bundle("blah") << endl;
     cout << "  Ufo:         " << has_bitmap("ufo") << endl;
     cout << "  Bundle test: " << has_resource_bundle("test") << endl;
-    
+
+    cout << "Loading in the background:" << endl;
+
+    load_resource_bundle_async("test", "test.txt");
+    while ( bundle_load_progress("test") < 1.0f )
+    {
+        cout << "  Progress:    " << bundle_load_progress("test") << endl;
+        process_events();
+    }
+
+    cout << "After background loading:" << endl;
+
+    cout << "  Animation:   " << has_animation_script("WalkingScript") << endl;
+    cout << "  Bitmap:      " << has_bitmap("FrogBmp") << endl;
+    cout << "  Font:        " << has_font("hara") << endl;
+    cout << "  Sound:       " << has_sound_effect("error") << endl;
+    cout << "  Music:       " << has_music("background") << endl;
+    cout << "  Timer:       " << has_timer("my timer") << endl;
+    cout << "  Bundle:      " << has_resource_bundle("blah") << endl;
+    cout << "  Ufo:         " << has_bitmap("ufo") << endl;
+    cout << "  Bundle test: " << has_resource_bundle("test") << endl;
+
+    free_resource_bundle("test");
+
+    // Freeing a bundle while it loads discards it once the work already started has finished
+    load_resource_bundle_async("test", "test.txt");
+    free_resource_bundle("test");
+
+    for (int i = 0; i < 100; i++)
+    {
+        process_events();
+        delay(10);
+    }
+
+    cout << "After freeing while loading (all 0):" << endl;
+
+    cout << "  Bitmap:      " << has_bitmap("FrogBmp") << endl;
+    cout << "  Sound:       " << has_sound_effect("error") << endl;
+    cout << "  Bundle:      " << has_resource_bundle("blah") << endl;
+    cout << "  Ufo:         " << has_bitmap("ufo") << endl;
+    cout << "  Bundle test: " << has_resource_bundle("test") << endl;
+
+    test_resource_packs();
 }
\ No newline at end of file
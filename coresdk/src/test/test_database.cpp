@@ -124,6 +124,85 @@ void run_database_tests()
     cout << "data should not be in db: " << query_column_for_double(cursor, 3) << endl;
     cout << "data should not be in db: " << query_column_for_bool(cursor, 4) << endl << endl;
 
+    //--------------------------------------------------------------
+
+    cout << "Testing prepared query..." << endl;
+    query_result insert = prepare_sql(db, "INSERT INTO friends VALUES (?, ?, ?, ?, ?);");
+    for (int i = 0; i < 3; i++)
+    {
+        reset_prepared_query(insert);
+        bind_int(insert, 1, 50005 + i);
+        bind_text(insert, 2, "O'Brien \"" + to_string(i) + "\"");
+        bind_int(insert, 3, 30 + i);
+        bind_double(insert, 4, 60.5 + i);
+        bind_int(insert, 5, i % 2);
+        cout << (step_query(insert) ? "Inserted row " : "Failed to insert row ") << i << endl;
+    }
+    free_query_result(insert);
+
+    query_result select = prepare_sql(db, "SELECT name FROM friends WHERE age >= ? ORDER BY id;");
+    bind_int(select, 1, 31);
+    for (step_query(select); has_row(select); get_next_row(select))
+    {
+        cout << "Expect O'Brien 1 and 2: " << query_column_for_string(select, 0) << endl;
+    }
+    free_query_result(select);
+
+    //--------------------------------------------------------------
+
+    cout << "Testing transactions and bulk insert..." << endl;
+    configure_database(db, true, true, 4096, 64);
+
+    begin_transaction(db);
+    run_sql(db, "DELETE FROM friends;");
+    rollback_transaction(db);
+    cursor = run_sql(db, "SELECT count(*) FROM friends;");
+    cout << "Expect 3 rows after rollback: " << query_column_for_int(cursor, 0) << endl;
+
+    vector<vector<string>> rows;
+    for (int i = 0; i < 10000; i++)
+    {
+        rows.push_back({ to_string(100000 + i), "Bulk " + to_string(i), to_string(i % 80), "70.5", "0" });
+    }
+    cout << "Expect 10000 rows inserted: " << bulk_insert(db, "friends", {"id", "name", "age", "weight", "isStudent"}, rows) << endl;
+    cout << "Expect 0 rows inserted for duplicate ids: " << bulk_insert(db, "friends", {"id", "name"}, {{"100001", "Dup"}}) << endl;
+
+    cursor = run_sql(db, "SELECT id, name, weight FROM friends ORDER BY id;");
+    cout << "Expect 10003 rows fetched: " << query_fetch_all(cursor) << endl;
+    vector<double> ids = query_fetched_numbers(cursor, 0);
+    vector<string> names = query_fetched_text(cursor, 1);
+    cout << "First row: " << ids[0] << " " << names[0] << ", last row: " << ids.back() << " " << names.back() << endl;
+
+    cursor = run_sql(db, "SELECT id, name FROM friends ORDER BY id LIMIT 2;");
+    json fetched = query_fetch_json(cursor, -1);
+    cout << "Rows as json: " << json_to_string(fetched) << endl;
+    free_json(fetched);
+
+    cursor = run_sql(db, "SELECT 9007199254740993 AS big_id, NULL AS missing;");
+    query_fetch_all(cursor);
+    cout << "Expect 9007199254740993: " << query_fetched_text(cursor, 0)[0] << ", expect null 1: " << query_fetched_nulls(cursor, 1)[0] << endl;
+
+    cout << "Testing async queries..." << endl;
+    query_result async_insert = run_sql_async(db, "INSERT INTO friends VALUES (60006, \"Async\", 50, 80.5, 0);");
+    cout << "Insert ready straight away? " << (query_ready(async_insert) ? "yes" : "no") << endl;
+    query_wait(async_insert);
+    cout << "Async insert " << (query_success(async_insert) ? "succeeded" : "failed") << endl;
+
+    // reads may run before earlier writes, so only count once the insert has finished
+    query_result async_count = run_sql_async(db, "SELECT count(*) FROM friends WHERE age < 80;");
+    query_wait(async_count);
+    cout << "Async count read " << query_fetch_rows(async_count, -1) << " row: " << query_fetched_numbers(async_count, 0)[0] << endl;
+
+    cout << "Testing query profiling..." << endl;
+    set_database_profiling(db, true);
+    set_slow_query_threshold(db, 1);
+    run_sql(db, "SELECT name FROM friends WHERE weight > 70 ORDER BY name;");
+    json stats = database_stats(db);
+    cout << "Database stats: " << json_to_string(stats) << endl;
+    free_json(stats);
+    set_slow_query_threshold(db, 0);
+    set_database_profiling(db, false);
+
     free_all_query_results();
 
     cout << "closing database" << endl;
@@ -13,6 +13,9 @@
 #include "random.h"
 #include "text.h"
 #include "utils.h"
+#include "images.h"
+#include "collisions.h"
+#include "point_drawing.h"
 
 #include <iostream>
 using namespace std;
@@ -105,6 +108,81 @@ void test_clipping(window w1)
     delay(3000);
 }
 
+// Fills the bitmap with a different colour in each quarter, one quarter per cell
+bitmap create_quarters_bitmap(const string &name)
+{
+    bitmap result = create_bitmap(name, 40, 40);
+    fill_rectangle(COLOR_RED, 0, 0, 20, 20, option_draw_to(result));
+    fill_rectangle(COLOR_GREEN, 20, 0, 20, 20, option_draw_to(result));
+    fill_rectangle(COLOR_BLUE, 0, 20, 20, 20, option_draw_to(result));
+    fill_rectangle(COLOR_GOLD, 20, 20, 20, 20, option_draw_to(result));
+    bitmap_set_cell_details(result, 20, 20, 2, 2, 4);
+    return result;
+}
+
+bool same_pixels(window w1, double x1, double y1, double x2, double y2, double w, double h)
+{
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++)
+        {
+            if ( color_to_string(get_pixel(w1, x1 + x, y1 + y)) != color_to_string(get_pixel(w1, x2 + x, y2 + y)) )
+                return false;
+        }
+    }
+    return true;
+}
+
+void test_atlas_drawing(window w1)
+{
+    bitmap plain = create_quarters_bitmap("plain");
+    bitmap in_atlas = create_quarters_bitmap("in_atlas");
+    bitmap neighbour = create_bitmap("neighbour", 40, 40);
+    clear_bitmap(neighbour, COLOR_PINK);
+
+    cout << "Added to atlas: " << atlas_add_bitmap(in_atlas) << " " << atlas_add_bitmap(neighbour) << endl;
+    cout << "In atlas: " << bitmap_in_atlas(in_atlas) << " (plain " << bitmap_in_atlas(plain) << ")" << endl;
+
+    clear_window(w1, COLOR_WHITE);
+    draw_text("Plain on the left, atlas on the right", COLOR_BLACK, 10, 10);
+
+    // Whole bitmap, then each cell, then scaled and flipped
+    draw_bitmap(plain, 10, 30);
+    draw_bitmap(in_atlas, 160, 30);
+    for (int i = 0; i < 4; i++)
+    {
+        draw_bitmap(plain, 60 + i * 22, 30, option_with_bitmap_cell(i));
+        draw_bitmap(in_atlas, 210 + i * 22, 30, option_with_bitmap_cell(i));
+    }
+    draw_bitmap(plain, 30, 100, option_scale_bmp(2, 2, option_flip_x()));
+    draw_bitmap(in_atlas, 180, 100, option_scale_bmp(2, 2, option_flip_x()));
+
+    // A part that reaches past the left and bottom edges must not show the neighbour
+    draw_bitmap(in_atlas, 160, 200, option_part_bmp(-10, 20, 40, 40, option_scale_bmp(2, 2)));
+
+    refresh_screen();
+
+    cout << "Whole bitmap matches: " << same_pixels(w1, 10, 30, 160, 30, 40, 40) << endl;
+    cout << "Cells match: " << same_pixels(w1, 60, 30, 210, 30, 86, 20) << endl;
+    cout << "Scaled and flipped matches: " << same_pixels(w1, 10, 80, 160, 80, 80, 80) << endl;
+
+    // The part is scaled around its centre, so the 80x80 result starts 20 up and left of the point
+    cout << "Clipped part - left is empty: " << (color_to_string(get_pixel(w1, 145, 185)) == color_to_string(COLOR_WHITE))
+         << ", blue follows: " << (color_to_string(get_pixel(w1, 165, 185)) == color_to_string(COLOR_BLUE))
+         << ", bottom is empty: " << (color_to_string(get_pixel(w1, 165, 225)) == color_to_string(COLOR_WHITE)) << endl;
+
+    cout << "Collision with cells: " << bitmap_collision(in_atlas, 0, 0, 0, plain, 0, 10, 10)
+         << " (expect 1), " << bitmap_collision(in_atlas, 0, 0, 0, plain, 0, 30, 30) << " (expect 0)" << endl;
+    cout << "Point collision: " << bitmap_point_collision(in_atlas, 0, 0, 35, 35)
+         << " (expect 1), " << bitmap_point_collision(in_atlas, 0, 0, 45, 45) << " (expect 0)" << endl;
+
+    delay(3000);
+
+    free_bitmap(plain);
+    free_bitmap(in_atlas);
+    free_bitmap(neighbour);
+}
+
 void run_graphics_test()
 {
     cout << "Checking the number of displays and their details" << endl;
@@ -126,6 +204,7 @@ void run_graphics_test()
     window w1 = open_window("Testing Graphics", 300, 300);
     
     test_clipping(w1);
+    test_atlas_drawing(w1);
     
     color in_clr = string_to_color("#ffeebbaa");
     
@@ -7,12 +7,63 @@
 //
 
 #include "resources.h"
+#include "images.h"
+#include "graphics.h"
+#include "point_drawing.h"
+#include "window_manager.h"
+#include "color.h"
+#include "utils.h"
 #include <iostream>
 
 using namespace std;
 using namespace splashkit_lib;
 
+void test_memory_budget()
+{
+    window wnd = open_window("Memory Budget", 400, 200);
+
+    unsigned int before = resource_memory_usage(IMAGE_RESOURCE);
+    bitmap second = load_bitmap("budget_second", "player.png");
+    unsigned int second_size = resource_memory_usage(IMAGE_RESOURCE) - before;
+
+    // Only room for one of the bitmaps, so loading the first evicts the second
+    set_resource_memory_budget(IMAGE_RESOURCE, before + second_size);
+    bitmap first = load_bitmap("budget_first", "ufo.png");
+    unsigned int first_size = resource_memory_usage(IMAGE_RESOURCE) - before;
+    cout << "Usage after loading first: " << resource_memory_usage(IMAGE_RESOURCE) << " (expect less than " << before + second_size << ")" << endl;
+
+    color first_pixel = get_pixel(first, 17, 16);
+    clear_window(wnd, COLOR_WHITE);
+    draw_bitmap(first, 0, 0);
+    color drawn_pixel = get_pixel(wnd, 17, 16);
+
+    // Drawing the second reloads it from its file, evicting the first
+    draw_bitmap(second, 50, 100);
+    cout << "Usage after drawing second: " << resource_memory_usage(IMAGE_RESOURCE) << " (expect " << before + second_size << ")" << endl;
+    cout << "First still has its size: " << bitmap_width(first) << "x" << bitmap_height(first) << " (expect 35x33)" << endl;
+
+    // Then the first is reloaded to read and draw it
+    cout << "First reads the same pixel after reload: " << (color_to_string(get_pixel(first, 17, 16)) == color_to_string(first_pixel)) << endl;
+
+    clear_window(wnd, COLOR_WHITE);
+    draw_bitmap(first, 0, 0);
+    cout << "First draws the same after reload: " << (color_to_string(get_pixel(wnd, 17, 16)) == color_to_string(drawn_pixel)) << endl;
+    cout << "Usage after reload: " << resource_memory_usage(IMAGE_RESOURCE) << " (expect " << before + first_size << ")" << endl;
+
+    refresh_screen();
+    delay(1000);
+
+    set_resource_memory_budget(IMAGE_RESOURCE, 0);
+    free_bitmap(first);
+    free_bitmap(second);
+    close_window(wnd);
+
+    cout << "Usage after free: " << resource_memory_usage(IMAGE_RESOURCE) << " (expect " << before << ")" << endl;
+}
+
 void run_resources_tests()
 {
     cout << "Resources path: " << path_to_resources() << endl;
-}
\ No newline at end of file
+
+    test_memory_budget();
+}
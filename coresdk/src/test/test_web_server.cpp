@@ -7,11 +7,16 @@
 
 #include "resources.h"
 #include "web_server.h"
+#include "web_client.h"
 #include "json.h"
+#include "networking.h"
+#include "utils.h"
 
 #include <iostream>
 #include <functional>
 #include <vector>
+#include <thread>
+#include <atomic>
 
 
 using namespace std;
@@ -141,6 +146,151 @@ void test_send_json_response()
     }
 }
 
+void test_websocket_echo()
+{
+    auto server = start_web_server();
+    web_server_websocket(server, "/echo");
+
+    cout << "Open http://localhost:8080 and type messages. Send 'stop' to finish.\n";
+
+    string page =
+        "<html><body><input id='msg'><pre id='log'></pre><script>"
+        "var ws = new WebSocket('ws://' + location.host + '/echo');"
+        "ws.onmessage = function(e) { document.getElementById('log').textContent += e.data + '\\n'; };"
+        "document.getElementById('msg').onchange = function(e) { ws.send(e.target.value); e.target.value = ''; };"
+        "</script></body></html>";
+
+    bool running = true;
+    while (running)
+    {
+        if (has_incoming_requests(server))
+        {
+            send_response(next_web_request(server), HTTP_STATUS_OK, page, "text/html");
+        }
+
+        while (has_new_websockets(server))
+        {
+            websocket ws = fetch_new_websocket(server);
+            cout << "Websocket opened on " << websocket_path(ws) << "\n";
+            websocket_send(ws, "Welcome");
+        }
+
+        while (has_websocket_messages(server))
+        {
+            message msg = read_websocket_message(server);
+            string data = message_data(msg);
+            cout << "Received: " << data << "\n";
+
+            if (data == "stop")
+            {
+                websocket_send(message_websocket(msg), "Goodbye");
+                running = false;
+            }
+            else
+            {
+                websocket_broadcast(server, "/echo", data);
+            }
+
+            close_message(msg);
+        }
+
+        delay(10);
+    }
+
+    stop_web_server(server);
+}
+
+static int cache_test_requests = 0;
+
+void handle_cache_test_request(http_request request)
+{
+    cache_test_requests++;
+
+    bool revalidating = false;
+    for (const string &header : request_headers(request))
+    {
+        if (header.find("If-None-Match") == 0) revalidating = true;
+    }
+
+    if (is_get_request_for(request, "/fresh"))
+    {
+        send_response(request, HTTP_STATUS_OK, "fresh body", "text/plain", {"Cache-Control: max-age=60"});
+    }
+    else if (revalidating)
+    {
+        send_response(request, HTTP_STATUS_NOT_MODIFIED, "", "text/plain", {"ETag: \"v1\"", "Cache-Control: no-cache"});
+    }
+    else
+    {
+        send_response(request, HTTP_STATUS_OK, "tagged body", "text/plain", {"ETag: \"v1\"", "Cache-Control: no-cache"});
+    }
+}
+
+// http_get blocks, so get on another thread while this one answers any requests that reach the server
+string cached_get(web_server server, const string &path)
+{
+    string body;
+    atomic<bool> done(false);
+
+    thread client([&]
+    {
+        http_response response = http_get("http://localhost:8080" + path, 8080);
+        body = http_response_to_string(response);
+        free_response(response);
+        done = true;
+    });
+
+    while (not done)
+    {
+        if (has_incoming_requests(server))
+        {
+            handle_cache_test_request(next_web_request(server));
+        }
+        delay(1);
+    }
+
+    client.join();
+    return body;
+}
+
+void check_cache_test(const string &name, bool passed)
+{
+    cout << (passed ? "PASS: " : "FAIL: ") << name << "\n";
+}
+
+void test_http_cache()
+{
+    auto server = start_web_server(8080);
+    enable_http_cache("http_cache_test");
+    clear_http_cache();
+
+    string body = cached_get(server, "/fresh");
+    check_cache_test("first get reaches the server", body == "fresh body" and cache_test_requests == 1);
+
+    body = cached_get(server, "/fresh");
+    check_cache_test("fresh entry is read from the cache", body == "fresh body" and cache_test_requests == 1);
+
+    body = cached_get(server, "/tagged");
+    check_cache_test("tagged get reaches the server", body == "tagged body" and cache_test_requests == 2);
+
+    body = cached_get(server, "/tagged");
+    check_cache_test("not modified reply uses the cached body", body == "tagged body" and cache_test_requests == 3);
+
+    // Re-enabling indexes the files already on disk
+    disable_http_cache();
+    enable_http_cache("http_cache_test");
+    body = cached_get(server, "/fresh");
+    check_cache_test("entries survive re-enabling the cache", body == "fresh body" and cache_test_requests == 3);
+
+    clear_http_cache();
+    body = cached_get(server, "/fresh");
+    check_cache_test("cleared cache gets from the server", body == "fresh body" and cache_test_requests == 4);
+
+    clear_http_cache();
+    disable_http_cache();
+    stop_web_server(server);
+}
+
 static vector<pair<string, function<void()>>> tests;
 
 void add_tests()
@@ -148,6 +298,8 @@ void add_tests()
     tests.push_back({"Single Server", run_single_server_test});
     tests.push_back({"Multiple Servers", run_multiple_server_test});
     tests.push_back({"Send JSON Response", test_send_json_response});
+    tests.push_back({"WebSocket Echo", test_websocket_echo});
+    tests.push_back({"HTTP Cache", test_http_cache});
 }
 
 void run_web_server_tests()
@@ -0,0 +1,133 @@
+/**
+ * Concurrency Unit Tests
+ */
+
+#include <vector>
+#include <thread>
+
+#include "catch.hpp"
+
+#include "concurrency_utils.h"
+
+using namespace splashkit_lib;
+
+TEST_CASE("mpmc queue reports full and empty", "[concurrency]")
+{
+    mpmc_queue<int, 4> queue;
+    int value;
+
+    REQUIRE_FALSE(queue.try_pop(value));
+
+    for (int i = 0; i < 4; i++)
+    {
+        REQUIRE(queue.try_push(i));
+    }
+    REQUIRE_FALSE(queue.try_push(4));
+
+    for (int i = 0; i < 4; i++)
+    {
+        REQUIRE(queue.try_pop(value));
+        REQUIRE(value == i);
+    }
+    REQUIRE_FALSE(queue.try_pop(value));
+}
+
+TEST_CASE("channel delivers every value with many producers and consumers", "[concurrency]")
+{
+    const int PRODUCERS = 4;
+    const int CONSUMERS = 4;
+    const int PER_PRODUCER = 20000;
+
+    // A small capacity makes producers wrap the queue and spill into the overflow
+    channel<int, 16> values;
+    std::vector<long long> sums(CONSUMERS, 0);
+    std::vector<int> counts(CONSUMERS, 0);
+    std::vector<std::thread> threads;
+
+    for (int c = 0; c < CONSUMERS; c++)
+    {
+        threads.emplace_back([&, c]
+        {
+            for (int value = values.take(); value >= 0; value = values.take())
+            {
+                sums[c] += value;
+                counts[c]++;
+            }
+        });
+    }
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; p++)
+    {
+        producers.emplace_back([&, p]
+        {
+            for (int i = 0; i < PER_PRODUCER; i++)
+            {
+                values.put(p * PER_PRODUCER + i);
+            }
+        });
+    }
+
+    for (auto &t : producers) t.join();
+
+    // One stop value per consumer - each will block in take until it arrives
+    for (int c = 0; c < CONSUMERS; c++) values.put(-1);
+    for (auto &t : threads) t.join();
+
+    long long total = 0;
+    int count = 0;
+    for (int c = 0; c < CONSUMERS; c++)
+    {
+        total += sums[c];
+        count += counts[c];
+    }
+
+    long long n = static_cast<long long>(PRODUCERS) * PER_PRODUCER;
+    REQUIRE(count == n);
+    REQUIRE(total == n * (n - 1) / 2);
+}
+
+TEST_CASE("channel keeps values in order past its capacity", "[concurrency]")
+{
+    channel<int, 16> values;
+    int value;
+
+    // Nothing is taking, so most of these go to the overflow without blocking
+    for (int i = 0; i < 100; i++)
+    {
+        values.put(i);
+    }
+
+    for (int i = 0; i < 100; i++)
+    {
+        REQUIRE(values.take() == i);
+    }
+    REQUIRE_FALSE(values.try_take(value));
+
+    // Once drained, values go through the queue again
+    values.put(100);
+    REQUIRE(values.take() == 100);
+}
+
+TEST_CASE("channel wakes a consumer for each put", "[concurrency]")
+{
+    // Ping-pong forces a consumer to sleep in take before almost every put
+    channel<int> ping, pong;
+
+    std::thread echo([&]
+    {
+        for (int value = ping.take(); value >= 0; value = ping.take())
+        {
+            pong.put(value);
+        }
+    });
+
+    for (int i = 0; i < 20000; i++)
+    {
+        ping.put(i);
+        REQUIRE(pong.take() == i);
+    }
+
+    ping.put(-1);
+    echo.join();
+}
@@ -88,6 +88,47 @@ TEST_CASE("json can be created and read", "[json]")
 
             REQUIRE(json_read_string(j, "firstName") == "John");
         }
+
+        SECTION("json can be written to/from compact text")
+        {
+            string json_string = json_to_compact_string(person);
+            json j = json_from_string(json_string);
+
+            REQUIRE(json_string.find('\n') == string::npos);
+            REQUIRE(json_read_string(j, "firstName") == "John");
+        }
+
+        SECTION("json can be written to/from binary formats")
+        {
+            for (json_format format : { JSON_MESSAGEPACK, JSON_CBOR, JSON_BSON })
+            {
+                vector<int8_t> bytes = json_to_bytes(person, format);
+                json j = json_from_bytes(bytes, format);
+
+                REQUIRE(bytes.size() < json_to_string(person).size());
+                REQUIRE(json_read_string(j, "firstName") == "John");
+                REQUIRE(json_read_number_as_int(json_read_object(j, "addresses"), "postalCode") == 10021);
+            }
+
+            string filename = "person.msgpack";
+            json_to_file(person, filename, JSON_MESSAGEPACK);
+            json j = json_from_file(filename, JSON_MESSAGEPACK);
+
+            REQUIRE(json_read_bool(j, "pensioner") == true);
+        }
+
+        SECTION("selected paths can be read from a file without loading it all")
+        {
+            string filename = "person.json";
+            json_to_file(person, filename);
+            json j = json_extract_paths(filename, { "/firstName", "/addresses/city", "/phoneNumbers/*" });
+
+            REQUIRE(json_count_keys(j) == 4);
+            REQUIRE(json_read_string(j, "/firstName") == "John");
+            REQUIRE(json_read_string(j, "/addresses/city") == "New York");
+            REQUIRE(json_read_string(j, "/phoneNumbers/1") == "646 555-4567");
+            REQUIRE_FALSE(json_has_key(j, "/lastName"));
+        }
     }
 
     SECTION("can check if key exists in json")
@@ -105,6 +146,37 @@ TEST_CASE("json can be created and read", "[json]")
         REQUIRE(json_count_keys(person) == 5);
     }
 
+    SECTION("can read values by path without copying")
+    {
+        REQUIRE(json_has_path(person, "/addresses/city"));
+        REQUIRE_FALSE(json_has_path(person, "/addresses/country"));
+        REQUIRE(json_read_string_at(person, "/addresses/city") == "New York");
+        REQUIRE(json_read_number_as_int_at(person, "/addresses/postalCode") == 10021);
+        REQUIRE(json_read_string_at(person, "/phoneNumbers/1") == "646 555-4567");
+        REQUIRE(json_read_bool_at(person, "/pensioner") == true);
+
+        json_view addresses = json_view_at(person, "/addresses");
+        REQUIRE(addresses == json_view_at(person, "/addresses"));
+        REQUIRE(json_view_count(addresses) == 4);
+        REQUIRE(json_view_has_key(addresses, "state"));
+        REQUIRE(json_view_read_string(addresses, "state") == "NY");
+
+        json_view numbers = json_view_at(person, "/phoneNumbers");
+        REQUIRE(json_view_count(numbers) == 2);
+        REQUIRE(json_view_element(numbers, 2) == nullptr);
+        REQUIRE(json_read_string(json_view_to_json(json_view_element(numbers, 0)), "value") == "212 555-1234");
+
+        REQUIRE(json_view_at(person, "/missing") == nullptr);
+
+        free_json_view(numbers);
+        REQUIRE(json_view_count(numbers) == 0);
+        REQUIRE(json_view_count(json_view_at(person, "/phoneNumbers")) == 2);
+
+        json_set_string(person, "note", "views are freed on change");
+        REQUIRE(json_view_count(addresses) == 0);
+        REQUIRE_FALSE(json_view_has_key(addresses, "state"));
+    }
+
     SECTION("can convert colors to/from json in hex form")
     {
         color clr = COLOR_BRIGHT_GREEN;
@@ -120,4 +192,30 @@ TEST_CASE("json can be created and read", "[json]")
 
     free_json(person);
     free_all_json();
-}
\ No newline at end of file
+}
+
+TEST_CASE("json arenas free the objects created within them", "[json]")
+{
+    json kept = create_json();
+    json_set_string(kept, "name", "kept");
+
+    json_arena_begin();
+    json first = create_json();
+    json second = create_json("{\"name\": \"second\"}");
+    free_json(first);
+
+    json_arena_begin();
+    json inner = create_json();
+    json_set_string(inner, "name", "inner");
+    json_arena_end();
+
+    REQUIRE(json_read_string(second, "name") == "second");
+    json_arena_end();
+
+    REQUIRE(json_read_string(kept, "name") == "kept");
+    REQUIRE_FALSE(json_has_key(second, "name"));
+    REQUIRE_FALSE(json_has_key(inner, "name"));
+    REQUIRE(json_count_keys(second) == 0);
+
+    free_json(kept);
+}
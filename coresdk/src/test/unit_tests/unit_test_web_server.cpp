@@ -0,0 +1,134 @@
+/**
+ * Web Server Response Encoding Unit Tests
+ */
+
+#include <string>
+
+#include "catch.hpp"
+
+#include "backend_types.h"
+#include "web_server_driver.h"
+
+using namespace splashkit_lib;
+
+// Returns the encoding headers for sending the body to a client with the Accept-Encoding header
+static string encoding_for(const string &body_text, const char *accept_encoding, unsigned long &sent_size)
+{
+    sk_http_response response;
+    response.content_type = "text/html";
+    response.message = const_cast<char *>(body_text.data());
+    response.message_size = body_text.size();
+
+    const char *body;
+    string compressed;
+    string headers = sk_encode_response_body(&response, accept_encoding, body, sent_size, compressed);
+
+    if ( sent_size == body_text.size() )
+        REQUIRE(body == body_text.data());
+
+    return headers;
+}
+
+static string repeated_text(size_t size)
+{
+    string result;
+    while (result.size() < size)
+    {
+        result += "<p>Hello from SplashKit</p>";
+    }
+    result.resize(size);
+    return result;
+}
+
+TEST_CASE("responses use the encoding the client accepts", "[web_server]")
+{
+    string page = repeated_text(4096);
+    unsigned long size;
+
+    SECTION("gzip is preferred")
+    {
+        string headers = encoding_for(page, "deflate, gzip", size);
+        REQUIRE(headers.find("Content-Encoding: gzip") != string::npos);
+        REQUIRE(size < page.size());
+    }
+
+    SECTION("deflate is used when gzip is not accepted")
+    {
+        REQUIRE(encoding_for(page, "deflate", size).find("Content-Encoding: deflate") != string::npos);
+    }
+
+    SECTION("codings with a zero quality are refused")
+    {
+        REQUIRE(encoding_for(page, "gzip;q=0, deflate", size).find("Content-Encoding: deflate") != string::npos);
+        REQUIRE(encoding_for(page, "gzip;q=0.0, deflate;q=0", size).find("Content-Encoding") == string::npos);
+        REQUIRE(size == page.size());
+    }
+
+    SECTION("the wildcard accepts codings that are not listed")
+    {
+        REQUIRE(encoding_for(page, "*", size).find("Content-Encoding: gzip") != string::npos);
+        REQUIRE(encoding_for(page, "*, gzip;q=0", size).find("Content-Encoding: deflate") != string::npos);
+        REQUIRE(encoding_for(page, "*;q=0", size).find("Content-Encoding") == string::npos);
+    }
+
+    SECTION("identity sends the body unchanged")
+    {
+        REQUIRE(encoding_for(page, "identity", size) == "Vary: Accept-Encoding\r\n");
+        REQUIRE(size == page.size());
+
+        REQUIRE(encoding_for(page, nullptr, size) == "Vary: Accept-Encoding\r\n");
+        REQUIRE(size == page.size());
+    }
+}
+
+TEST_CASE("only responses of at least 1KB are compressed", "[web_server]")
+{
+    unsigned long size;
+
+    REQUIRE(encoding_for(repeated_text(1023), "gzip", size).find("Content-Encoding") == string::npos);
+    REQUIRE(size == 1023);
+
+    REQUIRE(encoding_for(repeated_text(1024), "gzip", size).find("Content-Encoding: gzip") != string::npos);
+    REQUIRE(size < 1024);
+}
+
+TEST_CASE("responses with their own encoding or binary content are sent unchanged", "[web_server]")
+{
+    string page = repeated_text(4096);
+
+    sk_http_response response;
+    response.content_type = "image/png";
+    response.message = const_cast<char *>(page.data());
+    response.message_size = page.size();
+
+    const char *body;
+    unsigned long size;
+    string compressed;
+
+    REQUIRE(sk_encode_response_body(&response, "gzip", body, size, compressed) == "");
+    REQUIRE(size == page.size());
+
+    response.content_type = "text/html";
+    response.headers.push_back("Content-Encoding: br");
+
+    REQUIRE(sk_encode_response_body(&response, "gzip", body, size, compressed) == "");
+    REQUIRE(body == page.data());
+}
+
+TEST_CASE("compressed bodies are reused for repeated responses", "[web_server]")
+{
+    string page = repeated_text(8000) + "cache test";
+    unsigned long first_size, second_size;
+
+    unsigned long hits = sk_compression_cache_hits();
+    encoding_for(page, "gzip", first_size);
+    REQUIRE(sk_compression_cache_hits() == hits);
+
+    encoding_for(page, "gzip", second_size);
+    REQUIRE(sk_compression_cache_hits() == hits + 1);
+    REQUIRE(second_size == first_size);
+
+    // Each encoding is cached separately
+    encoding_for(page, "deflate", second_size);
+    REQUIRE(sk_compression_cache_hits() == hits + 1);
+}
@@ -0,0 +1,60 @@
+//
+//  skpak.cpp
+//  splashkit
+//
+//  Packs a resource bundle and its resource files into a single .skpak file.
+//
+
+#include "bundles.h"
+#include "resources.h"
+
+#include <iostream>
+#include <string>
+
+using namespace std;
+using namespace splashkit_lib;
+
+static void show_usage()
+{
+    cerr << "usage: skpak [-z] [-r resources_dir] <bundle file> <output.skpak>" << endl;
+    cerr << "  -z   compress the packed files" << endl;
+    cerr << "  -r   the Resources folder to read the bundle from" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    bool compress = false;
+    string resources_dir;
+    int i = 1;
+
+    for (; i < argc and argv[i][0] == '-'; i++)
+    {
+        string option = argv[i];
+
+        if ( option == "-z" )
+            compress = true;
+        else if ( option == "-r" and i + 1 < argc )
+            resources_dir = argv[++i];
+        else
+        {
+            show_usage();
+            return 1;
+        }
+    }
+
+    if ( argc - i != 2 )
+    {
+        show_usage();
+        return 1;
+    }
+
+    if ( not resources_dir.empty() ) set_resources_path(resources_dir);
+
+    if ( not pack_resource_bundle(argv[i], argv[i + 1], compress) )
+    {
+        cerr << "Unable to pack " << argv[i] << endl;
+        return 1;
+    }
+
+    return 0;
+}
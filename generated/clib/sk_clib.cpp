@@ -3307,6 +3307,40 @@ __sklib_string __sklib__query_column_for_string__query_result__int(__sklib_query
     string __skreturn = query_column_for_string(__skparam__db_result, __skparam__col);
     return __sklib__to_sklib_string(__skreturn);
 }
+int __sklib__query_fetch_all__query_result(__sklib_query_result db_result) {
+    query_result __skparam__db_result = __sklib__to_query_result(db_result);
+    int __skreturn = query_fetch_all(__skparam__db_result);
+    return __sklib__to_int(__skreturn);
+}
+__sklib_json __sklib__query_fetch_json__query_result__int(__sklib_query_result db_result, int max_rows) {
+    query_result __skparam__db_result = __sklib__to_query_result(db_result);
+    int __skparam__max_rows = __sklib__to_int(max_rows);
+    json __skreturn = query_fetch_json(__skparam__db_result, __skparam__max_rows);
+    return __sklib__to_sklib_json(__skreturn);
+}
+int __sklib__query_fetch_rows__query_result__int(__sklib_query_result db_result, int max_rows) {
+    query_result __skparam__db_result = __sklib__to_query_result(db_result);
+    int __skparam__max_rows = __sklib__to_int(max_rows);
+    int __skreturn = query_fetch_rows(__skparam__db_result, __skparam__max_rows);
+    return __sklib__to_int(__skreturn);
+}
+__sklib_vector_string __sklib__query_fetched_column_names__query_result(__sklib_query_result db_result) {
+    query_result __skparam__db_result = __sklib__to_query_result(db_result);
+    vector<string> __skreturn = query_fetched_column_names(__skparam__db_result);
+    return __sklib__to_sklib_vector_string(__skreturn);
+}
+__sklib_vector_double __sklib__query_fetched_numbers__query_result__int(__sklib_query_result db_result, int col) {
+    query_result __skparam__db_result = __sklib__to_query_result(db_result);
+    int __skparam__col = __sklib__to_int(col);
+    vector<double> __skreturn = query_fetched_numbers(__skparam__db_result, __skparam__col);
+    return __sklib__to_sklib_vector_double(__skreturn);
+}
+__sklib_vector_string __sklib__query_fetched_text__query_result__int(__sklib_query_result db_result, int col) {
+    query_result __skparam__db_result = __sklib__to_query_result(db_result);
+    int __skparam__col = __sklib__to_int(col);
+    vector<string> __skreturn = query_fetched_text(__skparam__db_result, __skparam__col);
+    return __sklib__to_sklib_vector_string(__skreturn);
+}
 int __sklib__query_success__query_result(__sklib_query_result db_result) {
     query_result __skparam__db_result = __sklib__to_query_result(db_result);
     bool __skreturn = query_success(__skparam__db_result);
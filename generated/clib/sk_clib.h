@@ -776,6 +776,12 @@ int __sklib__query_column_for_bool__query_result__int(__sklib_query_result db_re
 double __sklib__query_column_for_double__query_result__int(__sklib_query_result db_result, int col);
 int __sklib__query_column_for_int__query_result__int(__sklib_query_result db_result, int col);
 __sklib_string __sklib__query_column_for_string__query_result__int(__sklib_query_result db_result, int col);
+int __sklib__query_fetch_all__query_result(__sklib_query_result db_result);
+__sklib_json __sklib__query_fetch_json__query_result__int(__sklib_query_result db_result, int max_rows);
+int __sklib__query_fetch_rows__query_result__int(__sklib_query_result db_result, int max_rows);
+__sklib_vector_string __sklib__query_fetched_column_names__query_result(__sklib_query_result db_result);
+__sklib_vector_double __sklib__query_fetched_numbers__query_result__int(__sklib_query_result db_result, int col);
+__sklib_vector_string __sklib__query_fetched_text__query_result__int(__sklib_query_result db_result, int col);
 int __sklib__query_success__query_result(__sklib_query_result db_result);
 __sklib_string __sklib__query_type_of_col__query_result__int(__sklib_query_result db_result, int col);
 void __sklib__reset_query_result__query_result(__sklib_query_result db_result);
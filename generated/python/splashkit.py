@@ -2513,6 +2513,18 @@ sklib.__sklib__query_column_for_int__query_result__int.argtypes = [ c_void_p, c_
 sklib.__sklib__query_column_for_int__query_result__int.restype = c_int
 sklib.__sklib__query_column_for_string__query_result__int.argtypes = [ c_void_p, c_int ]
 sklib.__sklib__query_column_for_string__query_result__int.restype = _sklib_string
+sklib.__sklib__query_fetch_all__query_result.argtypes = [ c_void_p ]
+sklib.__sklib__query_fetch_all__query_result.restype = c_int
+sklib.__sklib__query_fetch_json__query_result__int.argtypes = [ c_void_p, c_int ]
+sklib.__sklib__query_fetch_json__query_result__int.restype = c_void_p
+sklib.__sklib__query_fetch_rows__query_result__int.argtypes = [ c_void_p, c_int ]
+sklib.__sklib__query_fetch_rows__query_result__int.restype = c_int
+sklib.__sklib__query_fetched_column_names__query_result.argtypes = [ c_void_p ]
+sklib.__sklib__query_fetched_column_names__query_result.restype = _sklib_vector_string
+sklib.__sklib__query_fetched_numbers__query_result__int.argtypes = [ c_void_p, c_int ]
+sklib.__sklib__query_fetched_numbers__query_result__int.restype = _sklib_vector_double
+sklib.__sklib__query_fetched_text__query_result__int.argtypes = [ c_void_p, c_int ]
+sklib.__sklib__query_fetched_text__query_result__int.restype = _sklib_vector_string
 sklib.__sklib__query_success__query_result.argtypes = [ c_void_p ]
 sklib.__sklib__query_success__query_result.restype = c_bool
 sklib.__sklib__query_type_of_col__query_result__int.argtypes = [ c_void_p, c_int ]
@@ -6359,6 +6371,34 @@ def query_column_for_string ( db_result, col ):
     __skparam__col = __skadapter__to_sklib_int(col)
     __skreturn = sklib.__sklib__query_column_for_string__query_result__int(__skparam__db_result, __skparam__col)
     return __skadapter__to_string(__skreturn)
+def query_fetch_all ( db_result ):
+    __skparam__db_result = __skadapter__to_sklib_query_result(db_result)
+    __skreturn = sklib.__sklib__query_fetch_all__query_result(__skparam__db_result)
+    return __skadapter__to_int(__skreturn)
+def query_fetch_json ( db_result, max_rows ):
+    __skparam__db_result = __skadapter__to_sklib_query_result(db_result)
+    __skparam__max_rows = __skadapter__to_sklib_int(max_rows)
+    __skreturn = sklib.__sklib__query_fetch_json__query_result__int(__skparam__db_result, __skparam__max_rows)
+    return __skadapter__to_json(__skreturn)
+def query_fetch_rows ( db_result, max_rows ):
+    __skparam__db_result = __skadapter__to_sklib_query_result(db_result)
+    __skparam__max_rows = __skadapter__to_sklib_int(max_rows)
+    __skreturn = sklib.__sklib__query_fetch_rows__query_result__int(__skparam__db_result, __skparam__max_rows)
+    return __skadapter__to_int(__skreturn)
+def query_fetched_column_names ( db_result ):
+    __skparam__db_result = __skadapter__to_sklib_query_result(db_result)
+    __skreturn = sklib.__sklib__query_fetched_column_names__query_result(__skparam__db_result)
+    return __skadapter__to_vector_string(__skreturn)
+def query_fetched_numbers ( db_result, col ):
+    __skparam__db_result = __skadapter__to_sklib_query_result(db_result)
+    __skparam__col = __skadapter__to_sklib_int(col)
+    __skreturn = sklib.__sklib__query_fetched_numbers__query_result__int(__skparam__db_result, __skparam__col)
+    return __skadapter__to_vector_double(__skreturn)
+def query_fetched_text ( db_result, col ):
+    __skparam__db_result = __skadapter__to_sklib_query_result(db_result)
+    __skparam__col = __skadapter__to_sklib_int(col)
+    __skreturn = sklib.__sklib__query_fetched_text__query_result__int(__skparam__db_result, __skparam__col)
+    return __skadapter__to_vector_string(__skreturn)
 def query_success ( db_result ):
     __skparam__db_result = __skadapter__to_sklib_query_result(db_result)
     __skreturn = sklib.__sklib__query_success__query_result(__skparam__db_result)